@@ -0,0 +1,439 @@
+#ifndef ANON_BINARY_HPP
+#define ANON_BINARY_HPP
+
+/**
+ * \file binary.hpp
+ *
+ * \brief Contains declarations and definitions regarding the binary encoding
+ */
+
+#include "./object.hpp"
+#include "./serializer.hpp"
+#include "./deserializer.hpp"
+#include "./variant_helper.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+/**
+ * \defgroup binary Binary encoding
+ *
+ * \brief This module contains a compact binary encoding, anonb, that uses the same type system as
+ * the text format
+ *
+ * A value is encoded as a type tag, followed by its body. The type tag is a single byte holding
+ * the index of the type in object::mapped_type. The body depends on the type:
+ *
+ * * Numbers are written in little-endian byte order, using the size of the type
+ *
+ * * Strings are written as a length, followed by the characters
+ *
+ * * Objects are written as the number of properties, followed by each property. A property is
+ *   written as a length-prefixed key, followed by the value, including its type tag.
+ *
+ * * Arrays are written as the number of elements, followed by the body of each element. Arrays
+ *   of numbers are stored as one contiguous block, so they can be read and written with a single
+ *   memcpy on little-endian machines.
+ *
+ * All lengths and counts are written as unsigned LEB128 varints. Since both encodings share the
+ * same type system, a value can be converted between the text form and the binary form without
+ * any loss.
+ *
+ * Since binary data is often received from other processes, the reader does not trust lengths
+ * before the corresponding data has arrived, and it rejects values where objects are nested deeper
+ * than binary_detail::max_depth levels.
+ */
+
+namespace anon
+{
+	namespace binary_detail
+	{
+		/**
+		 * \brief Maps T to the corresponding type in object::mapped_type
+		 */
+		template<class T>
+		struct canonical_type
+		{ using type = T; };
+
+		template<class Allocator>
+		struct canonical_type<std::basic_string<char, std::char_traits<char>, Allocator>>
+		{ using type = std::string; };
+
+		template<class Storage>
+		struct canonical_type<basic_object<Storage>>
+		{ using type = object; };
+
+		template<class T, class Allocator>
+		struct canonical_type<std::vector<T, Allocator>>
+		{ using type = std::vector<typename canonical_type<T>::type>; };
+
+		template<class Container>
+		struct canonical_type<cow_sequence<Container>>
+		{ using type = typename canonical_type<Container>::type; };
+
+		/**
+		 * \brief The type tag used for T
+		 */
+		template<class T>
+		constexpr auto type_tag = variant_helper::index_of<typename canonical_type<T>::type,
+			object::mapped_type>;
+
+		template<class T>
+		void to_little_endian(T* values, size_t n)
+		{
+			if constexpr(std::endian::native == std::endian::big && sizeof(T) != 1)
+			{
+				auto const bytes = reinterpret_cast<char*>(values);
+				for(size_t k = 0; k != n; ++k)
+				{ std::reverse(bytes + k*sizeof(T), bytes + (k + 1)*sizeof(T)); }
+			}
+		}
+
+		template<sink Sink>
+		void emit_varint(uint64_t value, Sink& sink)
+		{
+			std::array<char, 10> buffer;
+			size_t n = 0;
+			do
+			{
+				auto const byte = static_cast<uint8_t>(value & 0x7f);
+				value >>= 7;
+				buffer[n] = static_cast<char>(value != 0? byte | 0x80 : byte);
+				++n;
+			}
+			while(value != 0);
+			serializer_detail::emit(std::span{std::data(buffer), n}, sink);
+		}
+
+		template<sink Sink>
+		void emit_string(std::string_view value, Sink& sink)
+		{
+			emit_varint(std::size(value), sink);
+			serializer_detail::emit(value, sink);
+		}
+
+		/**
+		 * \brief Reads fixed-size blocks from a Source
+		 *
+		 * If the source would block, reading is retried. If the source ends before a block is
+		 * complete, an exception is thrown.
+		 */
+		template<source Source>
+		class reader
+		{
+		public:
+			explicit reader(Source& src):m_src{src}
+			{}
+
+			void read(std::span<char> dest)
+			{
+				if constexpr(chunked_source<Source>)
+				{
+					while(std::size(dest) != 0)
+					{
+						if(std::size(m_pending) == 0)
+						{ fetch(); }
+
+						auto const n = std::min(std::size(dest), std::size(m_pending));
+						memcpy(std::data(dest), std::data(m_pending), n);
+						dest = dest.subspan(n);
+						m_pending = m_pending.subspan(n);
+					}
+				}
+				else
+				{
+					std::ranges::for_each(dest, [this](auto& item) {
+						item = next_byte();
+					});
+				}
+			}
+
+			char next_byte()
+			{
+				if constexpr(chunked_source<Source>)
+				{
+					if(std::size(m_pending) == 0)
+					{ fetch(); }
+					auto const ret = m_pending[0];
+					m_pending = m_pending.subspan(1);
+					return ret;
+				}
+				else
+				{
+					while(true)
+					{
+						auto const res = read_byte(m_src);
+						switch(res.status)
+						{
+							case stream_status::ready:
+								return res.value;
+
+							case stream_status::eof:
+								throw std::runtime_error{"Empty or incomplete value"};
+
+							case stream_status::blocking:
+								break;
+						}
+					}
+				}
+			}
+
+			uint64_t read_varint()
+			{
+				uint64_t ret = 0;
+				for(int shift = 0; ; shift += 7)
+				{
+					auto const byte = static_cast<uint8_t>(next_byte());
+					// The tenth byte holds bit 63, and must not hold any more bits
+					if(shift == 63 && byte > 1)
+					{ throw std::runtime_error{"Invalid length"}; }
+
+					ret |= static_cast<uint64_t>(byte & 0x7f) << shift;
+					if((byte & 0x80) == 0)
+					{ return ret; }
+				}
+			}
+
+		private:
+			Source& m_src;
+			std::span<char const> m_pending;
+
+			void fetch()
+			{
+				while(true)
+				{
+					auto const res = read_chunk(m_src);
+					switch(res.status)
+					{
+						case stream_status::ready:
+							if(std::size(res.data) != 0)
+							{
+								m_pending = res.data;
+								return;
+							}
+							break;
+
+						case stream_status::eof:
+							throw std::runtime_error{"Empty or incomplete value"};
+
+						case stream_status::blocking:
+							break;
+					}
+				}
+			}
+		};
+
+		/**
+		 * \brief The maximum number of objects that may be nested inside each other
+		 *
+		 * Values are decoded recursively, so without a limit, a deeply nested value could exhaust the
+		 * stack.
+		 */
+		constexpr size_t max_depth = 256;
+
+		/**
+		 * \brief The maximum number of bytes that are allocated for a string or an array of numbers,
+		 * before its content has been read
+		 *
+		 * This way, a corrupt or hostile length cannot make the reader allocate more memory than
+		 * what is actually sent.
+		 */
+		constexpr size_t read_block_size = 65536;
+
+		/**
+		 * \brief Reads n elements into the end of dest, growing dest one block at a time
+		 */
+		template<class Container, class Reader>
+		void read_elements(Container& dest, uint64_t n, Reader& src)
+		{
+			using element_type = typename Container::value_type;
+			if(n > std::numeric_limits<size_t>::max()/sizeof(element_type))
+			{ throw std::runtime_error{"Invalid length"}; }
+
+			constexpr auto block_size = read_block_size/sizeof(element_type);
+			while(n != 0)
+			{
+				auto const offset = std::size(dest);
+				auto const count = static_cast<size_t>(std::min(n, static_cast<uint64_t>(block_size)));
+				dest.resize(offset + count);
+				src.read(std::span{reinterpret_cast<char*>(std::data(dest) + offset), count*sizeof(element_type)});
+				to_little_endian(std::data(dest) + offset, count);
+				n -= count;
+			}
+		}
+
+		template<class Object, class T, class Reader>
+		T read_body(Reader& src, typename Object::allocator_type const& alloc, size_t depth);
+
+		template<class Object, class Reader>
+		typename Object::mapped_type read_value(Reader& src, typename Object::allocator_type const& alloc,
+			size_t depth)
+		{
+			using mapped_type = typename Object::mapped_type;
+			auto const tag = static_cast<uint8_t>(src.next_byte());
+			if(tag >= std::variant_size_v<mapped_type>)
+			{ throw std::runtime_error{"Invalid type tag"}; }
+
+			mapped_type ret;
+			variant_helper::on_type_index<mapped_type>(tag, [&src, &alloc, depth, &ret]<class T>(variant_helper::empty<T>) {
+				ret = read_body<Object, T>(src, alloc, depth);
+			});
+			return ret;
+		}
+
+		template<class Object, class T, class Reader>
+		T read_body(Reader& src, typename Object::allocator_type const& alloc, size_t depth)
+		{
+			if constexpr(std::is_arithmetic_v<T>)
+			{
+				T ret{};
+				src.read(std::span{reinterpret_cast<char*>(&ret), sizeof(T)});
+				to_little_endian(&ret, 1);
+				return ret;
+			}
+			else
+			if constexpr(std::is_same_v<T, typename Object::string_type>)
+			{
+				T ret(alloc);
+				read_elements(ret, src.read_varint(), src);
+				return ret;
+			}
+			else
+			if constexpr(std::is_same_v<T, Object>)
+			{
+				if(depth == max_depth)
+				{ throw std::runtime_error{"Maximum nesting depth exceeded"}; }
+
+				Object ret{alloc};
+				auto const n = src.read_varint();
+				std::array<char, 32> key;
+				for(uint64_t k = 0; k != n; ++k)
+				{
+					auto const key_length = src.read_varint();
+					if(key_length >= std::size(key))
+					{ throw std::runtime_error{"Malformed property name"}; }
+
+					src.read(std::span{std::data(key), key_length});
+					typename Object::key_type name{std::string_view{std::data(key), key_length}};
+					ret.insert(std::move(name), read_value<Object>(src, alloc, depth + 1));
+				}
+				return ret;
+			}
+			else
+			{
+				using element_type = typename T::value_type;
+				T ret(alloc);
+				auto const n = src.read_varint();
+				if constexpr(std::is_arithmetic_v<element_type>)
+				{ read_elements(ret, n, src); }
+				else
+				{
+					for(uint64_t k = 0; k != n; ++k)
+					{ ret.push_back(read_body<Object, element_type>(src, alloc, depth)); }
+				}
+				return ret;
+			}
+		}
+	}
+
+	/**
+	 * \brief Writes value to sink, using the binary encoding
+	 *
+	 * \ingroup binary
+	 */
+	template<class T, sink Sink>
+	void store_binary(T const& value, Sink&& sink);
+
+	/**
+	 * \brief Writes value to sink, using the binary encoding, without the type tag
+	 *
+	 * \ingroup binary
+	 */
+	template<class T, sink Sink>
+	void store_binary_body(T const& value, Sink&& sink)
+	{
+		if constexpr(std::is_arithmetic_v<T>)
+		{
+			auto tmp = value;
+			binary_detail::to_little_endian(&tmp, 1);
+			serializer_detail::emit(std::span{reinterpret_cast<char const*>(&tmp), sizeof(T)}, sink);
+		}
+		else
+		if constexpr(std::is_same_v<typename binary_detail::canonical_type<T>::type, std::string>)
+		{ binary_detail::emit_string(value, sink); }
+		else
+		if constexpr(std::is_same_v<typename binary_detail::canonical_type<T>::type, object>)
+		{
+			binary_detail::emit_varint(std::size(value), sink);
+			std::ranges::for_each(value, [&sink](auto const& item) {
+				binary_detail::emit_string(std::string_view{item.first}, sink);
+				std::visit([&sink](auto const& value) {
+					store_binary(value, sink);
+				}, item.second);
+			});
+		}
+		else
+		{
+			using element_type = typename T::value_type;
+			binary_detail::emit_varint(std::size(value), sink);
+			if constexpr(std::is_arithmetic_v<element_type> && std::endian::native == std::endian::little)
+			{
+				serializer_detail::emit(std::span{reinterpret_cast<char const*>(std::data(value)),
+					std::size(value)*sizeof(element_type)}, sink);
+			}
+			else
+			{
+				std::ranges::for_each(value, [&sink](auto const& item) {
+					store_binary_body(item, sink);
+				});
+			}
+		}
+	}
+
+	template<class T, sink Sink>
+	void store_binary(T const& value, Sink&& sink)
+	{
+		static_assert(binary_detail::type_tag<T> != std::variant_npos, "Unsupported type");
+		serializer_detail::emit(static_cast<char>(binary_detail::type_tag<T>), sink);
+		store_binary_body(value, sink);
+	}
+
+	/**
+	 * \brief Generates the binary representation of value
+	 *
+	 * \ingroup binary
+	 */
+	template<class T>
+	std::string to_binary(T const& value)
+	{
+		std::string ret;
+		store_binary(value, string_writer{ret});
+		return ret;
+	}
+
+	/**
+	 * \brief Loads a value, stored in the binary encoding, from src
+	 *
+	 * \note If src is a chunked_source, data after the end of the value may have been consumed from
+	 * src.
+	 *
+	 * \ingroup binary
+	 */
+	template<class T = object, source Source>
+	T load_binary(Source&& src)
+	{
+		using object_type = typename deserializer_detail::object_type_of<T>::type;
+		binary_detail::reader reader{src};
+		return std::get<T>(binary_detail::read_value<object_type>(reader,
+			typename object_type::allocator_type{}, 0));
+	}
+}
+
+#endif
@@ -0,0 +1,199 @@
+//@	{"target":{"name":"binary.test"}}
+
+#include "./binary.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+namespace
+{
+	struct buffer
+	{
+		explicit buffer(std::string_view sv):data{sv}, ptr{std::begin(data)}
+		{}
+
+		std::string_view data;
+		char const* ptr;
+	};
+
+	anon::read_result read_byte(buffer& buff)
+	{
+		auto ret_val = buff.ptr != std::end(buff.data)? *buff.ptr : '\0';
+		auto ret_status = buff.ptr != std::end(buff.data) ?
+			anon::stream_status::ready: anon::stream_status::eof;
+		++buff.ptr;
+
+		return anon::read_result{ret_val, ret_status};
+	}
+
+	struct chunked_buffer
+	{
+		explicit chunked_buffer(std::string_view sv, size_t chunk_size):
+			data{sv},
+			ptr{std::begin(data)},
+			chunk_size{chunk_size}
+		{}
+
+		std::string_view data;
+		char const* ptr;
+		size_t chunk_size;
+	};
+
+	anon::chunk_read_result read_chunk(chunked_buffer& buff)
+	{
+		auto const n = std::min(buff.chunk_size, static_cast<size_t>(std::end(buff.data) - buff.ptr));
+		if(n == 0)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::eof}; }
+
+		auto const ret = std::span{buff.ptr, n};
+		buff.ptr += n;
+		return anon::chunk_read_result{ret, anon::stream_status::ready};
+	}
+
+	constexpr std::string_view text_src{R"(obj{
+	an_object: obj{
+		a_string: str{this is a test with ; \\ and { } \}
+		a_third_level: obj{
+			kaka:str{bulle\}
+		\}
+	\}
+	an_array_of_strings: str*{First string\;Second string\;\;\}
+	an_array_of_objects: obj*{
+		foobar:str*{A\;B\;C\;\}\;
+		key_in_second_obj:str{Hello world\}\;
+	\}
+	an_i32: i32{-2147483648\}
+	an_array_of_i32: i32*{1\;-2\;3\;\}
+	an_i64: i64{-9223372036854775808\}
+	an_array_of_i64: i64*{1\;2\;3\;\}
+	an_u32: u32{4294967295\}
+	an_array_of_u32: u32*{1\;2\;3\;\}
+	an_u64: u64{18446744073709551615\}
+	an_array_of_u64: u64*{1\;2\;3\;\}
+	an_f32: f32{0.1\}
+	an_array_of_f32: f32*{1e-30\;2.5\;3e30\;\}
+	an_f64: f64{0.1\}
+	an_array_of_f64: f64*{1e-300\;2.5\;3e300\;\}
+	an_empty_array_1: i32*{\}
+	an_empty_array_2: obj*{\}
+\})"};
+}
+
+TESTCASE(anon_binary_encoding)
+{
+	anon::object obj;
+	obj.insert(anon::property_name{"a"}, int32_t{1});
+	obj.insert(anon::property_name{"b"}, std::vector<uint32_t>{1, 256});
+	obj.insert(anon::property_name{"c"}, std::string(200, 'x'));
+
+	auto const bin = anon::to_binary(obj);
+	std::string expected{"\x07\x03"
+		"\x01" "a" "\x00" "\x01\x00\x00\x00"
+		"\x01" "b" "\x0a" "\x02" "\x01\x00\x00\x00" "\x00\x01\x00\x00"
+		"\x01" "c" "\x06" "\xc8\x01", 26};
+	expected.append(200, 'x');
+	EXPECT_EQ(bin, expected);
+}
+
+TESTCASE(anon_binary_round_trip)
+{
+	buffer text{text_src};
+	auto const obj = anon::load(text);
+	auto const bin = anon::to_binary(obj);
+	EXPECT_LT(std::size(bin), std::size(text_src));
+
+	{
+		buffer src{bin};
+		auto const loaded = anon::load_binary(src);
+		EXPECT_EQ(anon::to_string(loaded), anon::to_string(obj));
+		EXPECT_EQ(anon::to_binary(loaded), bin);
+		EXPECT_EQ(*src.ptr, '\0');
+	}
+
+	for(size_t chunk_size : {1, 2, 7, 4096})
+	{
+		chunked_buffer src{bin, chunk_size};
+		auto const loaded = anon::load_binary(src);
+		EXPECT_EQ(anon::to_string(loaded), anon::to_string(obj));
+	}
+
+	{
+		buffer src{bin};
+		auto const loaded = anon::load_binary<anon::map_object>(src);
+		EXPECT_EQ(anon::to_binary(loaded), bin);
+	}
+}
+
+TESTCASE(anon_binary_number_array)
+{
+	std::vector<double> values;
+	for(size_t k = 0; k != 10000; ++k)
+	{ values.push_back(1.0/static_cast<double>(k + 1)); }
+
+	auto const bin = anon::to_binary(values);
+	EXPECT_EQ(std::size(bin), 1 + 2 + sizeof(double)*std::size(values));
+
+	chunked_buffer src{bin, 4096};
+	EXPECT_EQ(anon::load_binary<std::vector<double>>(src), values);
+}
+
+TESTCASE(anon_binary_errors)
+{
+	buffer text{text_src};
+	auto const bin = anon::to_binary(anon::load(text));
+
+	for(size_t k = 0; k < std::size(bin); k += 17)
+	{
+		try
+		{
+			buffer src{std::string_view{std::data(bin), k}};
+			(void)anon::load_binary(src);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+
+	// Lengths that do not fit in memory, or that are larger than the data, must be rejected
+	// without allocating the claimed amount of memory. So must lengths with more than 64 bits.
+	for(auto const src : {std::string_view{"\x10", 1}, std::string_view{"\x07\x01\x01" "A" "\x00", 5},
+		std::string_view{"\x07\x01\x20", 3}, std::string_view{"\x06\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff", 11},
+		std::string_view{"\x06\x80\x80\x80\x80\x80\x80\x80\x80\x40" "abc", 13},
+		std::string_view{"\x0d\xff\xff\xff\xff\xff\xff\xff\xff\x7f" "abcdefgh", 18},
+		std::string_view{"\x06\x80\x80\x80\x80\x80\x80\x80\x80\x80\x02", 11},
+		std::string_view{"\x06\x80\x80\x80\x80\x80\x80\x80\x80\x80\x80\x00", 12}})
+	{
+		try
+		{
+			buffer buff{src};
+			(void)anon::load_binary(buff);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+}
+
+TESTCASE(anon_binary_nesting_depth)
+{
+	std::string nested;
+	for(size_t k = 0; k != 100000; ++k)
+	{ nested.append("\x07\x01\x01" "a"); }
+	nested.append("\x07\x00");
+
+	try
+	{
+		buffer buff{nested};
+		(void)anon::load_binary(buff);
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+
+	auto obj = anon::object{};
+	for(size_t k = 0; k != 255; ++k)
+	{ obj = anon::object{}.insert(anon::property_name{"a"}, std::move(obj)); }
+
+	auto const bin = anon::to_binary(obj);
+	buffer buff{bin};
+	EXPECT_EQ(anon::load_binary(buff), obj);
+}
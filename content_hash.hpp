@@ -0,0 +1,184 @@
+#ifndef ANON_CONTENTHASH_HPP
+#define ANON_CONTENTHASH_HPP
+
+/**
+ * \file content_hash.hpp
+ *
+ * \brief Contains functions for computing content hashes of values
+ */
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+namespace anon
+{
+	namespace hash_detail
+	{
+		/**
+		 * \brief The finalizer of splitmix64
+		 */
+		constexpr uint64_t mix(uint64_t x)
+		{
+			x ^= x >> 30;
+			x *= 0xbf58476d1ce4e5b9u;
+			x ^= x >> 27;
+			x *= 0x94d049bb133111ebu;
+			x ^= x >> 31;
+			return x;
+		}
+
+		/**
+		 * \brief Combines the hash value seed with value, such that the result depends on the order
+		 * of the combined values
+		 */
+		constexpr uint64_t combine(uint64_t seed, uint64_t value)
+		{ return mix(seed ^ (value + 0x9e3779b97f4a7c15u + (seed << 6) + (seed >> 2))); }
+
+		/**
+		 * \brief Hashes a sequence of bytes, eight bytes at a time
+		 */
+		inline uint64_t hash_bytes(std::string_view bytes)
+		{
+			auto ptr = std::data(bytes);
+			auto const end = ptr + std::size(bytes);
+			auto ret = mix(std::size(bytes));
+			while(end - ptr >= 8)
+			{
+				uint64_t word;
+				memcpy(&word, ptr, 8);
+				if constexpr(std::endian::native == std::endian::big)
+				{ word = __builtin_bswap64(word); }
+				ret = combine(ret, word);
+				ptr += 8;
+			}
+
+			uint64_t word = 0;
+			for(size_t k = 0; ptr != end; ++ptr, ++k)
+			{ word |= static_cast<uint64_t>(static_cast<uint8_t>(*ptr)) << (8*k); }
+			return combine(ret, word);
+		}
+
+		/**
+		 * \brief Holds a cached hash value, where zero means that no value has been computed
+		 *
+		 * A hash_cache can be read and written from multiple threads, since every thread computes
+		 * the same value. Moving a hash_cache leaves the source empty.
+		 *
+		 * A hash_cache is disabled when the owner hands out a reference that can be used to modify
+		 * the hashed content behind its back. A disabled cache never holds a value. Since such a
+		 * reference stays valid when the content is moved, or assigned to in place, the disabled
+		 * state follows the content on move, and is kept by the target of an assignment. A copy
+		 * has its own content, and starts enabled.
+		 */
+		class hash_cache
+		{
+		public:
+			hash_cache() = default;
+
+			hash_cache(hash_cache const& other):m_value{other.get()}
+			{}
+
+			hash_cache(hash_cache&& other) noexcept:
+				m_value{other.get()},
+				m_disabled{other.m_disabled}
+			{ other.reset(); }
+
+			hash_cache& operator=(hash_cache const& other)
+			{
+				m_value.store(m_disabled? 0 : other.get(), std::memory_order_relaxed);
+				return *this;
+			}
+
+			hash_cache& operator=(hash_cache&& other) noexcept
+			{
+				m_disabled = m_disabled || other.m_disabled;
+				m_value.store(m_disabled? 0 : other.get(), std::memory_order_relaxed);
+				other.reset();
+				return *this;
+			}
+
+			uint64_t get() const
+			{ return m_value.load(std::memory_order_relaxed); }
+
+			void set(uint64_t value) const
+			{
+				if(!m_disabled)
+				{ m_value.store(value, std::memory_order_relaxed); }
+			}
+
+			void reset()
+			{ m_value.store(0, std::memory_order_relaxed); }
+
+			void disable()
+			{
+				m_disabled = true;
+				reset();
+			}
+
+			bool disabled() const
+			{ return m_disabled; }
+
+		private:
+			mutable std::atomic<uint64_t> m_value{0};
+			bool m_disabled{false};
+		};
+	}
+
+	/**
+	 * \brief Computes a content hash of value
+	 *
+	 * The hash only depends on the content of value, and not on how it is stored. This means that
+	 * objects with different storage policies, allocators, or string types, but with the same
+	 * properties, have the same hash. The hash is also the same on all platforms, so it can be
+	 * stored, and used as a cache key.
+	 *
+	 * Objects cache their hash, which is computed from the hashes of their properties. Thus, the
+	 * hash of an object is a Merkle hash: after a modification, only the objects on the path to the
+	 * modified property need to be hashed again.
+	 *
+	 * \ingroup objects
+	 */
+	template<class T>
+	uint64_t content_hash(T const& value)
+	{
+		if constexpr(requires{ value.content_hash(); })
+		{ return value.content_hash(); }
+		else
+		if constexpr(std::is_integral_v<T>)
+		{ return hash_detail::mix(static_cast<uint64_t>(value)); }
+		else
+		if constexpr(std::is_floating_point_v<T>)
+		{
+			// Zero and negative zero are equal, and must therefore have the same hash value
+			using bits_type = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+			return hash_detail::mix(value == 0? 0 : std::bit_cast<bits_type>(value));
+		}
+		else
+		if constexpr(std::is_convertible_v<T const&, std::string_view>)
+		{ return hash_detail::hash_bytes(std::string_view{value}); }
+		else
+		if constexpr(requires{ value.index(); std::visit([](auto const&){}, value); })
+		{
+			return hash_detail::combine(hash_detail::mix(value.index()), std::visit([](auto const& item) {
+				return content_hash(item);
+			}, value));
+		}
+		else
+		{
+			static_assert(std::ranges::sized_range<T>, "Unsupported type");
+			auto ret = hash_detail::mix(std::size(value));
+			for(auto const& item : value)
+			{ ret = hash_detail::combine(ret, content_hash(item)); }
+			return ret;
+		}
+	}
+}
+
+#endif
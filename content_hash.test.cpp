@@ -0,0 +1,188 @@
+//@	{"target":{"name":"content_hash.test"}}
+
+#include "./content_hash.hpp"
+#include "./object.hpp"
+#include "./deserializer.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <array>
+#include <utility>
+
+namespace
+{
+	struct buffer
+	{
+		std::string_view data;
+		bool done{false};
+	};
+
+	anon::chunk_read_result read_chunk(buffer& buff)
+	{
+		if(buff.done)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::eof}; }
+
+		buff.done = true;
+		return anon::chunk_read_result{std::span{std::data(buff.data), std::size(buff.data)},
+			anon::stream_status::ready};
+	}
+
+	constexpr std::string_view src{R"(obj{
+	name: str{A somewhat longer string, that spans multiple words\}
+	settings: obj{network: obj{port: u32{80\} host: str{localhost\}\} colors: str*{red\;green\;\}\}
+	rows: obj*{id: u32{1\}\;id: u32{2\}\;\}
+	values: f64*{0\;1.5\;-2.25\;\}
+	offset: i64{-1\}
+\})"};
+}
+
+TESTCASE(anon_content_hash_scalars)
+{
+	EXPECT_EQ(anon::content_hash(0.0), anon::content_hash(-0.0));
+	EXPECT_EQ(anon::content_hash(0.0f), anon::content_hash(-0.0f));
+	EXPECT_NE(anon::content_hash(1.0), anon::content_hash(-1.0));
+	EXPECT_NE(anon::content_hash(int32_t{1}), anon::content_hash(int32_t{2}));
+
+	EXPECT_EQ(anon::content_hash(std::string{"Hello, World"}),
+		anon::content_hash(std::pmr::string{"Hello, World"}));
+	EXPECT_NE(anon::content_hash(std::string{"Hello, World"}),
+		anon::content_hash(std::string{"Hello, World!"}));
+	EXPECT_NE(anon::content_hash(std::string{}), anon::content_hash(std::string{"\0", 1}));
+
+	// The type of a value is part of the hash
+	EXPECT_NE(anon::content_hash(anon::object::mapped_type{int32_t{1}}),
+		anon::content_hash(anon::object::mapped_type{uint32_t{1}}));
+	EXPECT_NE(anon::content_hash(anon::object::mapped_type{std::vector<int32_t>{}}),
+		anon::content_hash(anon::object::mapped_type{std::vector<uint32_t>{}}));
+}
+
+TESTCASE(anon_content_hash_storage_independent)
+{
+	auto const a = anon::load(buffer{src});
+	auto const b = anon::load<anon::map_object>(buffer{src});
+	auto const c = anon::load<anon::interned_object>(buffer{src});
+	auto const d = anon::load<anon::persistent_object>(buffer{src});
+
+	std::array<std::byte, 4096> storage;
+	std::pmr::monotonic_buffer_resource arena{std::data(storage), std::size(storage)};
+	auto const e = anon::load(buffer{src}, arena);
+
+	EXPECT_NE(a.content_hash(), 0);
+	EXPECT_EQ(a.content_hash(), b.content_hash());
+	EXPECT_EQ(a.content_hash(), c.content_hash());
+	EXPECT_EQ(a.content_hash(), d.content_hash());
+	EXPECT_EQ(a.content_hash(), e.content_hash());
+	EXPECT_EQ(anon::content_hash(a), a.content_hash());
+
+	auto const copy = a;
+	EXPECT_EQ(copy.content_hash(), a.content_hash());
+	EXPECT_NE(anon::object{}.content_hash(), a.content_hash());
+}
+
+TESTCASE(anon_content_hash_invalidate)
+{
+	auto obj = anon::load(buffer{src});
+	auto const original = obj.content_hash();
+
+	obj.insert_or_assign("offset", int64_t{2});
+	auto const modified = obj.content_hash();
+	EXPECT_NE(modified, original);
+
+	obj.assign("offset", int64_t{-1});
+	EXPECT_EQ(obj.content_hash(), original);
+
+	obj.insert(anon::property_name{"extra"}, int32_t{1});
+	EXPECT_NE(obj.content_hash(), original);
+	obj.erase("extra");
+	EXPECT_EQ(obj.content_hash(), original);
+
+	// Modifying a nested object invalidates the cache of the enclosing objects
+	auto& settings = std::get<anon::object>(obj["settings"]);
+	std::get<anon::object>(settings["network"]).insert_or_assign("port", uint32_t{8080});
+	auto const nested_modified = obj.content_hash();
+	EXPECT_NE(nested_modified, original);
+
+	std::get<anon::object>(std::get<anon::object>(obj["settings"])["network"])
+		.insert_or_assign("port", uint32_t{80});
+	EXPECT_EQ(obj.content_hash(), original);
+
+	obj.clear();
+	EXPECT_EQ(obj.content_hash(), anon::object{}.content_hash());
+}
+
+TESTCASE(anon_content_hash_equality)
+{
+	auto const a = anon::load(buffer{src});
+	auto b = a;
+	EXPECT_EQ(a, b);
+
+	b.insert_or_assign("offset", int64_t{2});
+	EXPECT_NE(a.content_hash(), b.content_hash());
+	EXPECT_EQ(a == b, false);
+	EXPECT_EQ(a < b, true);
+
+	b.insert_or_assign("offset", int64_t{-1});
+	EXPECT_EQ(a.content_hash(), b.content_hash());
+	EXPECT_EQ(a, b);
+
+	auto const c = std::move(b);
+	EXPECT_EQ(c.content_hash(), a.content_hash());
+	EXPECT_EQ(c, a);
+}
+
+TESTCASE(anon_content_hash_equality_stale_cache)
+{
+	auto a = anon::load(buffer{src});
+	auto const b = anon::load(buffer{src});
+
+	// Modifying a property through a reference obtained before the hash was computed does not
+	// invalidate the cache, but must not affect comparison
+	auto& settings = std::get<anon::object>(a["settings"]);
+	(void)a.content_hash();
+	(void)b.content_hash();
+	std::get<anon::object>(settings["network"]).insert_or_assign("port", uint32_t{8080});
+	EXPECT_EQ(a == b, false);
+
+	std::get<anon::object>(settings["network"]).insert_or_assign("port", uint32_t{80});
+	(void)a.content_hash();
+	std::get<anon::object>(settings["network"]).insert_or_assign("port", uint32_t{8080});
+	auto c = b;
+	std::get<anon::object>(std::get<anon::object>(c["settings"])["network"])
+		.insert_or_assign("port", uint32_t{8080});
+	(void)c.content_hash();
+	EXPECT_EQ(a == c, true);
+}
+
+TESTCASE(anon_content_hash_modify_through_reference)
+{
+	auto obj = anon::load(buffer{src});
+	auto const original = obj.content_hash();
+
+	// References taken before the hash is computed
+	auto& offset = obj["offset"];
+	auto& network = std::get<anon::object>(std::get<anon::object>(obj["settings"])["network"]);
+	auto const item = std::begin(std::get<anon::object>(obj["settings"]));
+	EXPECT_EQ(obj.content_hash(), original);
+
+	offset = int64_t{2};
+	auto const offset_modified = obj.content_hash();
+	EXPECT_NE(offset_modified, original);
+
+	network.insert_or_assign("port", uint32_t{8080});
+	auto const port_modified = obj.content_hash();
+	EXPECT_NE(port_modified, offset_modified);
+
+	item->second = int32_t{1};
+	EXPECT_NE(obj.content_hash(), port_modified);
+
+	// A copy has no outstanding references, and gets the same hash as the modified object
+	auto const copy = obj;
+	EXPECT_EQ(copy.content_hash(), obj.content_hash());
+	EXPECT_EQ(copy, obj);
+
+	// The same holds for a moved object, since references follow the properties
+	auto moved = std::move(obj);
+	auto const before_move = moved.content_hash();
+	offset = int64_t{-1};
+	EXPECT_NE(moved.content_hash(), before_move);
+}
@@ -0,0 +1,304 @@
+#ifndef ANON_COROUTINE_HPP
+#define ANON_COROUTINE_HPP
+
+/**
+ * \file coroutine.hpp
+ *
+ * \brief Contains a coroutine API for asynchronous loading
+ */
+
+#include "./deserializer.hpp"
+#include "./record_reader.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <variant>
+
+namespace anon
+{
+	/**
+	 * \brief Defines the requirements of an executor, that resumes coroutines waiting for data
+	 *
+	 * An executor must provide a function `resume_when_readable(src, handle)`, which arranges for
+	 * handle to be resumed, once more data can be read from src. It is up to the executor how this
+	 * is detected. For example, epoll_executor watches the file descriptor of an fd_source.
+	 *
+	 * A coroutine may be destroyed while it waits, for example when a task that has not completed
+	 * goes out of scope. If the executor provides `cancel(src, handle)`, it is called in that
+	 * case, so the executor does not resume a destroyed coroutine. An executor without cancel must
+	 * not outlive any coroutine that waits for it, unless all such coroutines complete.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class T, class Source>
+	concept executor = requires(T& exec, Source& src, std::coroutine_handle<> handle)
+	{
+		{ exec.resume_when_readable(src, handle) };
+	};
+
+	/**
+	 * \brief A lazily started coroutine, that produces a T
+	 *
+	 * A task starts when it is awaited, and the awaiting coroutine is resumed when the task has
+	 * completed. From code that is not a coroutine, a task can be started with start. Its result is
+	 * available when done returns true.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class T>
+	class task
+	{
+	public:
+		struct promise_type
+		{
+			std::variant<std::monostate, T, std::exception_ptr> result;
+			std::coroutine_handle<> continuation;
+
+			task get_return_object()
+			{ return task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+			std::suspend_always initial_suspend() noexcept
+			{ return {}; }
+
+			auto final_suspend() noexcept
+			{
+				struct final_awaiter
+				{
+					bool await_ready() noexcept
+					{ return false; }
+
+					std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+					{
+						auto const continuation = handle.promise().continuation;
+						return continuation? continuation : std::noop_coroutine();
+					}
+
+					void await_resume() noexcept
+					{}
+				};
+				return final_awaiter{};
+			}
+
+			template<class U>
+			void return_value(U&& value)
+			{ result.template emplace<1>(std::forward<U>(value)); }
+
+			void unhandled_exception()
+			{ result.template emplace<2>(std::current_exception()); }
+		};
+
+		task(task&& other) noexcept:m_handle{std::exchange(other.m_handle, nullptr)}
+		{}
+
+		task& operator=(task&& other) noexcept
+		{
+			std::swap(m_handle, other.m_handle);
+			return *this;
+		}
+
+		~task()
+		{
+			if(m_handle)
+			{ m_handle.destroy(); }
+		}
+
+		auto operator co_await() && noexcept
+		{
+			struct awaiter
+			{
+				std::coroutine_handle<promise_type> handle;
+
+				bool await_ready() noexcept
+				{ return false; }
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+				{
+					handle.promise().continuation = continuation;
+					return handle;
+				}
+
+				T await_resume()
+				{ return take_result(handle); }
+			};
+			return awaiter{m_handle};
+		}
+
+		/**
+		 * \brief Runs the task until it completes, or waits for data
+		 */
+		void start()
+		{ m_handle.resume(); }
+
+		/**
+		 * \brief Checks whether or not the task has completed
+		 */
+		bool done() const
+		{ return m_handle.done(); }
+
+		/**
+		 * \brief Returns the result of a completed task, or rethrows the exception it exited with
+		 */
+		T result()
+		{ return take_result(m_handle); }
+
+	private:
+		explicit task(std::coroutine_handle<promise_type> handle):m_handle{handle}
+		{}
+
+		std::coroutine_handle<promise_type> m_handle;
+
+		static T take_result(std::coroutine_handle<promise_type> handle)
+		{
+			auto& result = handle.promise().result;
+			if(auto error = std::get_if<std::exception_ptr>(&result); error != nullptr)
+			{ std::rethrow_exception(*error); }
+			return std::move(std::get<T>(result));
+		}
+	};
+
+	/**
+	 * \brief Suspends the awaiting coroutine, until exec finds that more data can be read from src
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class Source, executor<Source> Executor>
+	auto wait_readable(Source& src, Executor& exec)
+	{
+		struct awaiter
+		{
+			Source& src;
+			Executor& exec;
+			std::coroutine_handle<> waiting{};
+
+			awaiter(Source& src, Executor& exec):src{src}, exec{exec}
+			{}
+
+			awaiter(awaiter const&) = delete;
+			awaiter& operator=(awaiter const&) = delete;
+
+			// The awaiter lives in the coroutine frame, so it is destroyed together with a
+			// coroutine that is destroyed while waiting
+			~awaiter()
+			{
+				if constexpr(requires{ exec.cancel(src, waiting); })
+				{
+					if(waiting)
+					{ exec.cancel(src, waiting); }
+				}
+			}
+
+			bool await_ready() noexcept
+			{ return false; }
+
+			void await_suspend(std::coroutine_handle<> handle)
+			{
+				waiting = handle;
+				try
+				{ exec.resume_when_readable(src, handle); }
+				catch(...)
+				{
+					waiting = nullptr;
+					throw;
+				}
+			}
+
+			void await_resume() noexcept
+			{ waiting = nullptr; }
+		};
+		return awaiter{src, exec};
+	}
+
+	namespace coroutine_detail
+	{
+		// Source is either a reference, or a value that has been moved into the coroutine frame
+		template<class T, class Source, class Executor>
+		task<T> async_load(Source src, Executor& exec)
+		{
+			async_loader<Source, typename deserializer_detail::object_type_of<T>::type>
+				loader{std::forward<Source>(src)};
+			while(true)
+			{
+				if(auto res = loader.template try_read_next<T>(); res.has_value())
+				{ co_return std::move(*res); }
+				co_await wait_readable(loader.source(), exec);
+			}
+		}
+	}
+
+	/**
+	 * \brief Loads a T from src, and suspends whenever src would block
+	 *
+	 * This is the asynchronous version of load. Instead of retrying when src reports
+	 * stream_status::blocking, the awaiting coroutine is suspended until exec resumes it.
+	 *
+	 * \note If src is an lvalue, it must outlive the returned task. Otherwise, it is moved into the
+	 * task.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class T = object, source Source, class Executor>
+	requires(executor<Executor, std::remove_reference_t<Source>>)
+	task<T> async_load(Source&& src, Executor& exec)
+	{ return coroutine_detail::async_load<T, Source>(std::forward<Source>(src), exec); }
+
+	/**
+	 * \brief An asynchronous stream of records, built on record_reader
+	 *
+	 * Each call to next returns a task, which completes when the next record has been read. While
+	 * no data is available, the awaiting coroutine is suspended until exec resumes it.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<source Source, class Executor, class Object = object>
+	requires(executor<Executor, std::remove_reference_t<Source>>)
+	class async_record_reader
+	{
+	public:
+		explicit async_record_reader(Source&& src, Executor& exec):
+			m_reader{std::forward<Source>(src)},
+			m_executor{exec}
+		{}
+
+		/**
+		 * \brief Reads the next record
+		 *
+		 * \return A task that produces a pointer to the record, or nullptr if the stream ended
+		 * between two records. The record is valid until next is called again, but it may be moved
+		 * out of the reader.
+		 */
+		task<Object*> next()
+		{
+			while(true)
+			{
+				switch(m_reader.read_next())
+				{
+					case stream_status::ready:
+						co_return &m_reader.current();
+
+					case stream_status::eof:
+						co_return nullptr;
+
+					case stream_status::blocking:
+						co_await wait_readable(m_reader.source(), m_executor);
+						break;
+				}
+			}
+		}
+
+		/**
+		 * \brief Returns the counters collected by the underlying record_reader
+		 */
+		record_reader_stats const& stats() const
+		{ return m_reader.stats(); }
+
+	private:
+		record_reader<Source, Object> m_reader;
+		Executor& m_executor;
+	};
+
+	template<source Source, class Executor>
+	async_record_reader(Source&, Executor&) -> async_record_reader<Source&, Executor>;
+}
+
+#endif
@@ -0,0 +1,155 @@
+//@	{"target":{"name":"coroutine.test"}}
+
+#include "./coroutine.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <deque>
+#include <string>
+
+namespace
+{
+	// A chunked source that would block before each chunk
+	struct chunked_buffer
+	{
+		explicit chunked_buffer(std::string_view sv, size_t chunk_size):
+			data{sv},
+			ptr{std::begin(data)},
+			chunk_size{chunk_size}
+		{}
+
+		std::string_view data;
+		char const* ptr;
+		size_t chunk_size;
+		bool readable{false};
+	};
+
+	anon::chunk_read_result read_chunk(chunked_buffer& buff)
+	{
+		if(!buff.readable)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::blocking}; }
+		buff.readable = false;
+
+		auto const n = std::min(buff.chunk_size, static_cast<size_t>(std::end(buff.data) - buff.ptr));
+		if(n == 0)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::eof}; }
+
+		auto const ret = std::span{buff.ptr, n};
+		buff.ptr += n;
+		return anon::chunk_read_result{ret, anon::stream_status::ready};
+	}
+
+	// Makes the source readable, and resumes the waiting coroutine from run_once
+	struct queue_executor
+	{
+		std::deque<std::pair<chunked_buffer*, std::coroutine_handle<>>> waiting;
+		size_t suspensions{0};
+
+		void resume_when_readable(chunked_buffer& src, std::coroutine_handle<> handle)
+		{
+			waiting.emplace_back(&src, handle);
+			++suspensions;
+		}
+
+		bool run_once()
+		{
+			if(std::size(waiting) == 0)
+			{ return false; }
+
+			auto const item = waiting.front();
+			waiting.pop_front();
+			item.first->readable = true;
+			item.second.resume();
+			return true;
+		}
+	};
+
+	static_assert(anon::executor<queue_executor, chunked_buffer>);
+
+	constexpr std::string_view src{R"(obj{a: i32{1\} b: str{Hello, World\} c: f64*{1\;2\;3\;\}\})"};
+
+	anon::task<size_t> count_properties(chunked_buffer& buff, queue_executor& exec)
+	{
+		auto obj = co_await anon::async_load(buff, exec);
+		co_return std::size(obj);
+	}
+}
+
+TESTCASE(anon_async_load)
+{
+	chunked_buffer buff{src, 8};
+	queue_executor exec;
+	auto task = anon::async_load(buff, exec);
+	task.start();
+	while(!task.done())
+	{ REQUIRE_EQ(exec.run_once(), true); }
+
+	auto obj = task.result();
+	EXPECT_EQ(std::get<int32_t>(obj["a"]), 1);
+	EXPECT_EQ(std::get<std::string>(obj["b"]), "Hello, World");
+	EXPECT_EQ(exec.suspensions, (std::size(src) + 7)/8);
+}
+
+TESTCASE(anon_async_load_nested)
+{
+	chunked_buffer buff{src, 3};
+	queue_executor exec;
+	auto task = count_properties(buff, exec);
+	task.start();
+	while(exec.run_once())
+	{}
+	REQUIRE_EQ(task.done(), true);
+	EXPECT_EQ(task.result(), 3);
+}
+
+TESTCASE(anon_async_load_error)
+{
+	chunked_buffer buff{R"(obj{a: foo{1\}\})", 4};
+	queue_executor exec;
+	auto task = anon::async_load(buff, exec);
+	task.start();
+	while(exec.run_once())
+	{}
+	REQUIRE_EQ(task.done(), true);
+	try
+	{
+		(void)task.result();
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+}
+
+namespace
+{
+	anon::task<std::vector<uint64_t>> collect_ids(anon::async_record_reader<chunked_buffer&, queue_executor>& reader)
+	{
+		std::vector<uint64_t> ret;
+		while(auto record = co_await reader.next())
+		{ ret.push_back(std::get<uint64_t>((*record)["id"])); }
+		co_return ret;
+	}
+}
+
+TESTCASE(anon_async_record_reader)
+{
+	std::string records;
+	for(size_t k = 0; k != 20; ++k)
+	{ records.append("obj{id: u64{").append(std::to_string(k)).append("\\}\\}\n"); }
+
+	chunked_buffer buff{records, 5};
+	queue_executor exec;
+	anon::async_record_reader reader{buff, exec};
+	auto task = collect_ids(reader);
+	task.start();
+	while(exec.run_once())
+	{}
+
+	REQUIRE_EQ(task.done(), true);
+	auto const ids = task.result();
+	REQUIRE_EQ(std::size(ids), 20);
+	for(size_t k = 0; k != std::size(ids); ++k)
+	{ EXPECT_EQ(ids[k], k); }
+	EXPECT_EQ(reader.stats().records, 20);
+	EXPECT_EQ(reader.stats().blocked_reads, exec.suspensions);
+}
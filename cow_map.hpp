@@ -0,0 +1,184 @@
+#ifndef ANON_COWMAP_HPP
+#define ANON_COWMAP_HPP
+
+/**
+ * \file cow_map.hpp
+ *
+ * \brief Contains the definition of cow_map
+ */
+
+#include "./flat_map.hpp"
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace anon
+{
+	/**
+	 * \brief A flat_map with copy-on-write semantics
+	 *
+	 * Copying a cow_map only copies a reference-counted pointer to its elements. The elements are
+	 * copied the first time a copy that shares them is modified. Only the member functions that
+	 * modify the map copy the elements. Lookup and iteration always give const access, also on a
+	 * non-const cow_map. To modify the value of an existing element, use find_for_write.
+	 *
+	 * Elements that are themselves cow_maps, or other copy-on-write types, are shared by the new
+	 * copy. Thus, modifying a value deep down in a tree of cow_maps only copies the element tables
+	 * of the maps on the path to it.
+	 *
+	 * Multiple threads may read copies that share the same elements. A single cow_map must not
+	 * be modified by one thread while another thread is copying it.
+	 *
+	 * \note References obtained through find_for_write must not be used after the cow_map has
+	 * been copied, since they would then refer to shared elements
+	 *
+	 * \ingroup objects
+	 */
+	template<class Key, class Value, class Compare = std::less<>>
+	class cow_map
+	{
+	public:
+		using map_type = flat_map<Key, Value, Compare>;
+		using key_type = Key;
+		using mapped_type = Value;
+		using value_type = typename map_type::value_type;
+		using allocator_type = typename map_type::allocator_type;
+		using iterator = typename map_type::iterator;
+		using const_iterator = typename map_type::const_iterator;
+
+		cow_map() = default;
+
+		explicit cow_map(allocator_type const&)
+		{}
+
+		explicit cow_map(cow_map const& other, allocator_type const&):m_content{other.m_content}
+		{}
+
+		explicit cow_map(cow_map&& other, allocator_type const&):m_content{std::move(other.m_content)}
+		{}
+
+		explicit cow_map(sorted_unique_t, std::vector<value_type>&& items):
+			m_content{std::make_shared<map_type>(sorted_unique, std::move(items))}
+		{}
+
+		/**
+		 * \brief Inserts item, unless there already is an element with the same key
+		 */
+		template<class P>
+		std::pair<iterator, bool> insert(P&& item)
+		{ return detach().insert(std::forward<P>(item)); }
+
+		/**
+		 * \brief Inserts a new element with key key, or updates the value of an existing element
+		 */
+		template<class T>
+		std::pair<iterator, bool> insert_or_assign(key_type&& key, T&& val)
+		{ return detach().insert_or_assign(std::move(key), std::forward<T>(val)); }
+
+		/**
+		 * \brief Looks up the element with key key
+		 */
+		template<class K>
+		const_iterator find(K const& key) const
+		{ return content().find(key); }
+
+		/**
+		 * \brief Returns a pointer to the value of the element with key key, so it can be modified,
+		 * or nullptr if there is no such element
+		 *
+		 * The elements are only copied if the key exists.
+		 */
+		template<class K>
+		mapped_type* find_for_write(K const& key)
+		{
+			if(!contains(key))
+			{ return nullptr; }
+			return &detach().find(key)->second;
+		}
+
+		/**
+		 * \brief Checks whether or not there is an element with key key
+		 */
+		template<class K>
+		bool contains(K const& key) const
+		{ return content().contains(key); }
+
+		/**
+		 * \brief Removes the element at pos
+		 */
+		iterator erase(const_iterator pos)
+		{
+			auto const offset = pos - std::begin(content());
+			auto& elements = detach();
+			return elements.erase(std::begin(elements) + offset);
+		}
+
+		/**
+		 * \brief Returns the number of elements
+		 */
+		size_t size() const
+		{ return std::size(content()); }
+
+		/**
+		 * \brief Removes all elements
+		 *
+		 * \note Storage is only kept if it is not shared with another cow_map
+		 */
+		void clear()
+		{
+			if(m_content.use_count() == 1)
+			{ m_content->clear(); }
+			else
+			{ m_content.reset(); }
+		}
+
+		allocator_type get_allocator() const
+		{ return allocator_type{}; }
+
+		/**
+		 * \brief Checks whether or not this cow_map shares its elements with other
+		 */
+		bool shares_storage_with(cow_map const& other) const
+		{ return m_content != nullptr && m_content == other.m_content; }
+
+		/**
+		 * \name Iterator access
+		 */
+		///@{
+		const_iterator begin() const
+		{ return std::begin(content()); }
+
+		const_iterator end() const
+		{ return std::end(content()); }
+		///@}
+
+		bool operator==(cow_map const& other) const
+		{ return m_content == other.m_content || content() == other.content(); }
+
+		auto operator<=>(cow_map const& other) const
+		{ return content() <=> other.content(); }
+
+	private:
+		std::shared_ptr<map_type> m_content;
+
+		map_type const& content() const
+		{
+			static map_type const empty;
+			return m_content != nullptr? *m_content : empty;
+		}
+
+		map_type& detach()
+		{
+			if(m_content == nullptr)
+			{ m_content = std::make_shared<map_type>(); }
+			else
+			if(m_content.use_count() != 1)
+			{ m_content = std::make_shared<map_type>(*m_content); }
+			return *m_content;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,166 @@
+//@	{"target":{"name":"cow_map.test"}}
+
+#include "./cow_map.hpp"
+#include "./object.hpp"
+#include "./deserializer.hpp"
+#include "./serializer.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace
+{
+	struct buffer
+	{
+		std::string_view data;
+		bool done{false};
+	};
+
+	anon::chunk_read_result read_chunk(buffer& buff)
+	{
+		if(buff.done)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::eof}; }
+
+		buff.done = true;
+		return anon::chunk_read_result{std::span{std::data(buff.data), std::size(buff.data)},
+			anon::stream_status::ready};
+	}
+}
+
+TESTCASE(anon_cow_map_copy_on_write)
+{
+	anon::cow_map<std::string, int> a;
+	EXPECT_EQ(std::size(a), 0);
+	a.insert_or_assign("a", 1);
+	a.insert_or_assign("b", 2);
+
+	auto b = a;
+	EXPECT_EQ(b.shares_storage_with(a), true);
+	EXPECT_EQ(b == a, true);
+
+	// Reading does not copy
+	EXPECT_EQ(std::as_const(b).find(std::string_view{"a"})->second, 1);
+	EXPECT_EQ(b.shares_storage_with(a), true);
+
+	b.insert_or_assign("c", 3);
+	EXPECT_EQ(b.shares_storage_with(a), false);
+	EXPECT_EQ(std::size(a), 2);
+	EXPECT_EQ(std::size(b), 3);
+	EXPECT_EQ(a.contains(std::string_view{"c"}), false);
+	EXPECT_EQ(b == a, false);
+
+	auto c = b;
+	c.erase(c.find(std::string_view{"a"}));
+	EXPECT_EQ(std::size(b), 3);
+	EXPECT_EQ(std::size(c), 2);
+
+	auto d = c;
+	d.clear();
+	EXPECT_EQ(std::size(c), 2);
+	EXPECT_EQ(std::size(d), 0);
+	EXPECT_EQ((d == anon::cow_map<std::string, int>{}), true);
+}
+
+TESTCASE(anon_persistent_object_snapshot)
+{
+	constexpr std::string_view src{R"(obj{
+	name: str{Test\}
+	settings: obj{network: obj{port: u32{80\}\} colors: str*{red\;green\;\}\}
+	rows: obj*{id: u32{1\}\;id: u32{2\}\;\}
+\})"};
+
+	buffer buff{src};
+	auto version_1 = anon::load<anon::persistent_object>(buff);
+	auto const snapshot = version_1;
+
+	auto& settings = std::get<anon::persistent_object>(version_1["settings"]);
+	std::get<anon::persistent_object>(settings["network"]).insert_or_assign("port", uint32_t{8080});
+
+	// The snapshot is unaffected
+	auto const& old_settings = std::get<anon::persistent_object>(snapshot["settings"]);
+	EXPECT_EQ(std::get<uint32_t>(std::get<anon::persistent_object>(old_settings["network"])["port"]), 80);
+	EXPECT_EQ(std::get<uint32_t>(
+		std::get<anon::persistent_object>(std::as_const(settings)["network"])["port"]), 8080);
+
+	// Objects that are not on the path to the modified property are still shared
+	using row_array = anon::persistent_object::array_type<anon::persistent_object>;
+	auto const& rows = std::get<row_array>(std::as_const(version_1)["rows"]);
+	auto const& old_rows = std::get<row_array>(snapshot["rows"]);
+	EXPECT_EQ(rows.shares_storage_with(old_rows), true);
+	EXPECT_EQ(&rows[0]["id"], &old_rows[0]["id"]);
+
+	// Strings and arrays in nodes on the path are not copied
+	using string_array = anon::persistent_object::array_type<anon::persistent_object::string_type>;
+	auto const& colors = std::get<string_array>(std::as_const(settings)["colors"]);
+	auto const& old_colors = std::get<string_array>(old_settings["colors"]);
+	EXPECT_NE(&colors, &old_colors);
+	EXPECT_EQ(colors.shares_storage_with(old_colors), true);
+	EXPECT_EQ(std::get<anon::persistent_object::string_type>(std::as_const(version_1)["name"])
+		.shares_storage_with(std::get<anon::persistent_object::string_type>(snapshot["name"])), true);
+
+	EXPECT_EQ(version_1 == snapshot, false);
+	EXPECT_EQ(anon::to_string(snapshot), anon::to_string(anon::load<anon::persistent_object>(buffer{src})));
+	version_1.erase("settings");
+	EXPECT_EQ(std::size(version_1), 2);
+	EXPECT_EQ(std::size(snapshot), 3);
+}
+
+TESTCASE(anon_persistent_object_read_does_not_copy)
+{
+	constexpr std::string_view src{R"(obj{
+	name: str{Test\}
+	settings: obj{network: obj{port: u32{80\}\}\}
+\})"};
+
+	buffer buff{src};
+	auto const original = anon::load<anon::persistent_object>(buff);
+	auto copy = original;
+
+	EXPECT_EQ(&std::begin(copy)->second, &std::begin(original)->second);
+	EXPECT_EQ(&copy.find("settings")->second, &original.find("settings")->second);
+	EXPECT_EQ(copy.contains("missing"), false);
+
+	// Assigning to a property that does not exist is not a modification
+	try
+	{
+		copy.assign("missing", int32_t{1});
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+	EXPECT_EQ(&std::begin(copy)->second, &std::begin(original)->second);
+
+	copy.assign("name", anon::persistent_object::string_type{"Other"});
+	EXPECT_NE(&std::begin(copy)->second, &std::begin(original)->second);
+	EXPECT_EQ(std::get<anon::persistent_object::string_type>(original["name"]).get(), "Test");
+}
+
+TESTCASE(anon_cow_sequence_copy_on_write)
+{
+	anon::cow_vector<int> a;
+	EXPECT_EQ(std::size(a), 0);
+	a.push_back(1);
+	a.push_back(2);
+
+	auto b = a;
+	EXPECT_EQ(b.shares_storage_with(a), true);
+	EXPECT_EQ(b[1], 2);
+	EXPECT_EQ(*std::begin(b), 1);
+	EXPECT_EQ(b.shares_storage_with(a), true);
+
+	b.data()[0] = 3;
+	EXPECT_EQ(b.shares_storage_with(a), false);
+	EXPECT_EQ(a[0], 1);
+	EXPECT_EQ(b[0], 3);
+	EXPECT_EQ(a < b, true);
+
+	anon::cow_string str{"Hello"};
+	auto other = str;
+	std::string_view const suffix{", World"};
+	other.insert(std::end(other), std::begin(suffix), std::end(suffix));
+	EXPECT_EQ(std::string_view{str}, "Hello");
+	EXPECT_EQ(std::string_view{other}, "Hello, World");
+}
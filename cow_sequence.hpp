@@ -0,0 +1,190 @@
+#ifndef ANON_COWSEQUENCE_HPP
+#define ANON_COWSEQUENCE_HPP
+
+/**
+ * \file cow_sequence.hpp
+ *
+ * \brief Contains the definition of cow_sequence
+ */
+
+#include <compare>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace anon
+{
+	/**
+	 * \brief A sequence container, with copy-on-write semantics, that wraps Container
+	 *
+	 * Copying a cow_sequence only copies a reference-counted pointer to its elements. The elements
+	 * are copied the first time a copy that shares them is modified. Only the member functions that
+	 * modify the sequence copy the elements. Element access and iteration always give const access,
+	 * also on a non-const cow_sequence. To modify elements in place, use data.
+	 *
+	 * \note The same thread-safety rules as for cow_map apply
+	 *
+	 * \ingroup objects
+	 */
+	template<class Container>
+	class cow_sequence
+	{
+	public:
+		using container_type = Container;
+		using value_type = typename Container::value_type;
+		using allocator_type = typename Container::allocator_type;
+		using size_type = typename Container::size_type;
+		using const_iterator = typename Container::const_iterator;
+		using iterator = const_iterator;
+
+		cow_sequence() = default;
+
+		/**
+		 * \brief Constructs the elements from args, as if constructing a Container
+		 */
+		template<class... Args>
+		requires(sizeof...(Args) != 0
+			&& !(sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, cow_sequence> && ...))
+			&& std::is_constructible_v<Container, Args...>)
+		explicit cow_sequence(Args&&... args):
+			m_content{std::make_shared<Container>(std::forward<Args>(args)...)}
+		{}
+
+		/**
+		 * \brief Returns the elements
+		 */
+		Container const& get() const
+		{
+			static Container const empty;
+			return m_content != nullptr? *m_content : empty;
+		}
+
+		/**
+		 * \brief Returns the number of elements
+		 */
+		size_type size() const
+		{ return std::size(get()); }
+
+		bool empty() const
+		{ return std::empty(get()); }
+
+		/**
+		 * \name data
+		 *
+		 * \brief Returns a pointer to the first element
+		 *
+		 * \note The non-const version is considered a modification
+		 */
+		///@{
+		auto data() const
+		{ return std::data(get()); }
+
+		auto data()
+		{ return std::data(detach()); }
+		///@}
+
+		value_type const& operator[](size_type index) const
+		{ return get()[index]; }
+
+		/**
+		 * \name Iterator access
+		 */
+		///@{
+		const_iterator begin() const
+		{ return std::begin(get()); }
+
+		const_iterator end() const
+		{ return std::end(get()); }
+		///@}
+
+		template<class T>
+		void push_back(T&& value)
+		{ detach().push_back(std::forward<T>(value)); }
+
+		template<class... Args>
+		decltype(auto) emplace_back(Args&&... args)
+		{ return detach().emplace_back(std::forward<Args>(args)...); }
+
+		/**
+		 * \brief Inserts the elements in [first, last) before pos
+		 */
+		template<class InputIterator>
+		void insert(const_iterator pos, InputIterator first, InputIterator last)
+		{
+			auto const offset = pos - begin();
+			auto& content = detach();
+			content.insert(std::begin(content) + offset, first, last);
+		}
+
+		void resize(size_type size)
+		{ detach().resize(size); }
+
+		void reserve(size_type size)
+		{ detach().reserve(size); }
+
+		/**
+		 * \brief Removes all elements
+		 *
+		 * \note Storage is only kept if it is not shared with another cow_sequence
+		 */
+		void clear()
+		{
+			if(m_content.use_count() == 1)
+			{ m_content->clear(); }
+			else
+			{ m_content.reset(); }
+		}
+
+		/**
+		 * \brief Checks whether or not this cow_sequence shares its elements with other
+		 */
+		bool shares_storage_with(cow_sequence const& other) const
+		{ return m_content != nullptr && m_content == other.m_content; }
+
+		/**
+		 * \brief Converts a sequence of characters into a std::string_view
+		 */
+		operator std::string_view() const requires(std::is_same_v<Container, std::string>)
+		{ return get(); }
+
+		bool operator==(cow_sequence const& other) const
+		{ return m_content == other.m_content || get() == other.get(); }
+
+		auto operator<=>(cow_sequence const& other) const
+		{ return get() <=> other.get(); }
+
+	private:
+		std::shared_ptr<Container> m_content;
+
+		Container& detach()
+		{
+			if(m_content == nullptr)
+			{ m_content = std::make_shared<Container>(); }
+			else
+			if(m_content.use_count() != 1)
+			{ m_content = std::make_shared<Container>(*m_content); }
+			return *m_content;
+		}
+	};
+
+	/**
+	 * \brief A string with copy-on-write semantics
+	 *
+	 * \ingroup objects
+	 */
+	using cow_string = cow_sequence<std::string>;
+
+	/**
+	 * \brief An array with copy-on-write semantics
+	 *
+	 * \ingroup objects
+	 */
+	template<class T>
+	using cow_vector = cow_sequence<std::vector<T>>;
+}
+
+#endif
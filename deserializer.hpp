@@ -11,10 +11,15 @@
 
 #include "./object.hpp"
 #include "./type_info.hpp"
+#include "./event_parser.hpp"
+#include "./schema.hpp"
+#include "./source.hpp"
+#include "./mmap_source.hpp"
 
 #include <stack>
 #include <filesystem>
 #include <optional>
+#include <span>
 
 /**
  * \defgroup de-serialization De-serialization
@@ -25,119 +30,196 @@ namespace anon
 	namespace deserializer_detail
 	{
 		/**
-		* \brief Holds the current parsing context
+		* \brief Holds the current parsing context, when building an Object
+		*
+		* \note The parser is available for object, map_object, interned_object, pmr_object, and
+		* persistent_object
 		*
 		* \ingroup de-serialization
 		*/
-		struct parser_context;
+		template<class Object>
+		struct basic_parser_context;
+
+		/**
+		* \brief Holds the current parsing context, when building an object
+		*
+		* \ingroup de-serialization
+		*/
+		using parser_context = basic_parser_context<object>;
 
 		/**
 		 * \brief Destroys ctxt
 		 *
 		 * \ingroup de-serialization
 		 */
-		void destroy_parser_context(parser_context* ctxt);
+		template<class Object>
+		void destroy_parser_context(basic_parser_context<Object>* ctxt);
 
 		struct parser_context_deleter
 		{
-			void operator()(parser_context* ctxt)
+			template<class Object>
+			void operator()(basic_parser_context<Object>* ctxt)
 			{
 				destroy_parser_context(ctxt);
 			}
 		};
-	}
-
-	/**
-	 * \brief Defines the current status of a stream
-	 *
-	 * \ingroup de-serialization
-	 *
-	 */
-	enum class stream_status:char{ready, eof, blocking};
 
-	/**
-	 * \brief Holder for the result of a read operation
-	 *
-	 * \ingroup de-serialization
-	 */
-	struct read_result
-	{
 		/**
-		 * \brief Holds the last value read from a input stream, only useful of if status is ready.
+		 * \brief Determines which object type to build in order to load a T
 		 */
-		char value;
+		template<class T>
+		struct object_type_of
+		{ using type = object; };
 
-		/**
-		 * \brief Determines the status of the input stream
-		 */
-		stream_status status;
-	};
+		template<class Storage>
+		struct object_type_of<basic_object<Storage>>
+		{ using type = basic_object<Storage>; };
+
+		template<class Storage, class Allocator>
+		struct object_type_of<std::vector<basic_object<Storage>, Allocator>>
+		{ using type = basic_object<Storage>; };
+
+		template<class Storage>
+		struct object_type_of<cow_vector<basic_object<Storage>>>
+		{ using type = basic_object<Storage>; };
 
-	/**
-	 * \brief Defines the requirements of a "source"
-	 *
-	 * A source is something that can be read from, for example, an input buffer or a file.
-	 *
-	 * \ingroup de-serialization
-	 *
-	 */
-	template<class T>
-	concept source = requires(T a)
-	{
 		/**
-		 * \brief Shall try to consume next byte and return a read_result with appropriate values
+		 * \brief Feeds data from src to process, until process reports that a value is complete
+		 *
+		 * process is called either with a span, or with a single char, depending on whether or not
+		 * Source is a chunked_source. Any data that has been read from src, but not yet consumed, is
+		 * kept in pending.
+		 *
+		 * \return true if a value was completed, and false if src would block
 		 */
-		{ read_byte(a) } -> std::same_as<read_result>;
-	};
+		template<source Source, class Process>
+		bool feed(Source& src, std::span<char const>& pending, Process&& process)
+		{
+			if constexpr(chunked_source<Source>)
+			{
+				while(true)
+				{
+					if(std::size(pending) == 0)
+					{
+						auto const read_res = read_chunk(src);
+						switch(read_res.status)
+						{
+							case stream_status::ready:
+								pending = read_res.data;
+								break;
+
+							case stream_status::eof:
+								throw std::runtime_error{"Empty or incomplete value"};
+
+							case stream_status::blocking:
+								return false;
+						}
+					}
+
+					auto const res = process(pending);
+					pending = pending.subspan(res.bytes_consumed);
+					if(res.status == parse_result::done)
+					{ return true; }
+				}
+			}
+			else
+			{
+				while(true)
+				{
+					auto const read_res = read_byte(src);
+					switch(read_res.status)
+					{
+						case stream_status::ready:
+							if(process(read_res.value) == parse_result::done)
+							{ return true; }
+							break;
+
+						case stream_status::eof:
+							throw std::runtime_error{"Empty or incomplete value"};
+
+						case stream_status::blocking:
+							return false;
+					}
+				}
+			}
+		}
+	}
 
-	using parser_context_handle =
-		std::unique_ptr<deserializer_detail::parser_context, deserializer_detail::parser_context_deleter>;
+	template<class Object>
+	using basic_parser_context_handle = std::unique_ptr<deserializer_detail::basic_parser_context<Object>,
+		deserializer_detail::parser_context_deleter>;
+
+	using parser_context_handle = basic_parser_context_handle<object>;
 
 	/**
 	 * \brief Creates a new parser context
 	 *
+	 * All values created by the parser are allocated using alloc.
+	 *
 	 *  \ingroup de-serialization
 	 */
-	parser_context_handle create_parser_context();
+	template<class Object = object>
+	basic_parser_context_handle<Object>
+	create_parser_context(typename Object::allocator_type const& alloc = {});
 
 	/**
 	 * \brief Extracts the latest result from ctxt, and resets ctxt to its initial state
 	 *
 	 * \ingroup de-serialization
 	 */
-	object::mapped_type take_result_and_reset(deserializer_detail::parser_context& ctxt);
+	template<class Object>
+	typename Object::mapped_type
+	take_result_and_reset(deserializer_detail::basic_parser_context<Object>& ctxt);
 
 	/**
-	* \brief Holds the result after processing one byte
+	* \brief Processes input, and updates ctxt accordingly
+	*
+	* \note If an error occurs during processing of input, an exception is thrown
+	*
+	* \return parse_result::done if the outermost object was closed, otherwise
+	*         parse_result::more_data_needed
 	*
 	* \ingroup de-serialization
 	*/
-	enum class parse_result{done, more_data_needed};
+	template<class Object>
+	parse_result update(char input, deserializer_detail::basic_parser_context<Object>& ctxt);
 
 	/**
 	* \brief Processes input, and updates ctxt accordingly
 	*
-	* \note If an error occurs during processing of input, an exception is thrown
+	* This function feeds all bytes in input to the parser, until the outermost object is closed,
+	* or there is no more input. Any bytes after the end of the outermost object are not consumed.
 	*
-	* \return parse_result::done if the outermost object was closed, otherwise
-	*         parse_result::more_data_needed
+	* \note If an error occurs during processing of input, an exception is thrown
 	*
 	* \ingroup de-serialization
 	*/
-	parse_result update(char input, deserializer_detail::parser_context& ctxt);
+	template<class Object>
+	update_result update(std::span<char const> input,
+		deserializer_detail::basic_parser_context<Object>& ctxt);
 
 	/**
 	 * \brief Class for asynchronous loading of data
 	 *
+	 * Objects that are read by the loader are built as Object.
+	 *
 	 * \ingroup de-serialization
 	 */
-	template<source Source>
+	template<source Source, class Object = object>
 	class async_loader
 	{
 	public:
 		explicit async_loader(Source&& src):
 			m_source{std::forward<Source>(src)},
-			m_parser_ctxt{create_parser_context()}
+			m_parser_ctxt{create_parser_context<Object>()}
+		{}
+
+		/**
+		 * \brief Creates a loader, that allocates all values it reads using alloc
+		 */
+		explicit async_loader(Source&& src, typename Object::allocator_type const& alloc):
+			m_source{std::forward<Source>(src)},
+			m_parser_ctxt{create_parser_context<Object>(alloc)}
 		{}
 
 		/**
@@ -146,37 +228,27 @@ namespace anon
 		 * This function tries to read the next T from the source associated with this loader. If
 		 * it is not possible to pull more data without blocking, std::nullopt is returned. In case
 		 * something different than a T was read, it will throw an exception.
+		 *
+		 * \note If Source is a chunked_source, any data after the end of the value is kept by the
+		 * loader, and used by the next call to try_read_next.
 		 */
 		template<class T>
 		std::optional<T> try_read_next()
 		{
-			while(true)
-			{
-				auto const read_res = read_byte(m_source);
-				switch(read_res.status)
-				{
-					case stream_status::ready:
-						if(update(read_res.value, *m_parser_ctxt) == parse_result::done)
-						{
-							return std::get<T>(take_result_and_reset(*m_parser_ctxt));
-						}
-						break;
-
-					case stream_status::eof:
-						throw std::runtime_error{"Empty or incomplete value"};
-
-					case stream_status::blocking:
-						return std::nullopt;
-				}
-			}
+			if(deserializer_detail::feed(m_source, m_pending, [this](auto input) {
+				return update(input, *m_parser_ctxt);
+			}))
+			{ return std::get<T>(take_result_and_reset(*m_parser_ctxt)); }
+			return std::nullopt;
 		}
 
 		decltype(auto) source()
-		{ return m_source; }
+		{ return (m_source); }
 
 	private:
 		Source m_source;
-		parser_context_handle m_parser_ctxt;
+		basic_parser_context_handle<Object> m_parser_ctxt;
+		std::span<char const> m_pending;
 	};
 
 	template<source Source>
@@ -186,12 +258,56 @@ namespace anon
 	 * \brief Loads an object from src, and returns it. In case of a blocking stream, it will try
 	 * again.
 	 *
+	 * If T is a described struct, the value is read directly into a T, without building an object.
+	 *
+	 * \note If src is a chunked_source, data after the end of the object may have been consumed
+	 * from src.
+	 *
 	 * \ingroup de-serialization
 	 */
 	template<class T = object, source Source>
 	T load(Source&& src)
 	{
-		async_loader loader{std::forward<Source>(src)};
+		if constexpr(described<T>)
+		{
+			T ret{};
+			event_parser parser{struct_builder{ret}};
+			std::span<char const> pending;
+			while(!deserializer_detail::feed(src, pending, [&parser](auto input) {
+				return parser.update(input);
+			}))
+			{}
+			return ret;
+		}
+		else
+		{
+			async_loader<Source, typename deserializer_detail::object_type_of<T>::type>
+				loader{std::forward<Source>(src)};
+			while(true)
+			{
+				if(auto res = loader.template try_read_next<T>(); res.has_value())
+				{ return std::move(*res); }
+			}
+		}
+	}
+
+	/**
+	 * \brief Loads an object from src, and allocates all its memory from resource
+	 *
+	 * This function makes it possible to place an entire object tree in a single arena, such as a
+	 * `std::pmr::monotonic_buffer_resource`. Then, the tree can be freed at once, by releasing the
+	 * arena. In this case, the returned object must not be used after the arena has been released.
+	 *
+	 * \note The returned object must not outlive resource
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class T = pmr_object, source Source>
+	T load(Source&& src, std::pmr::memory_resource& resource)
+	{
+		using object_type = typename deserializer_detail::object_type_of<T>::type;
+		async_loader<Source, object_type> loader{std::forward<Source>(src),
+			typename object_type::allocator_type{&resource}};
 		while(true)
 		{
 			if(auto res = loader.template try_read_next<T>(); res.has_value())
@@ -229,25 +345,44 @@ namespace anon
 	 *
 	 * \ingroup de-serialization
 	 */
-	inline object load(FILE* src)
+	template<class T = object>
+	T load(FILE* src)
 	{
-		return load(cfile_reader{src});
+		return load<T>(cfile_reader{src});
 	}
 
 	/**
 	 * \brief Loads an object path
 	 *
+	 * If path refers to a non-empty regular file, the file is read through an mmap_source.
+	 * Otherwise, or if the file cannot be mapped, it is read through the C file API. This way,
+	 * files in procfs and sysfs, which report a size of zero, can still be loaded.
+	 *
 	 * \ingroup de-serialization
 	 */
-	inline object load(std::filesystem::path const& path)
+	template<class T = object>
+	T load(std::filesystem::path const& path)
 	{
+		std::error_code ec;
+		if(is_regular_file(path, ec) && file_size(path, ec) != 0 && !ec)
+		{
+			std::optional<mmap_source> mapped;
+			try
+			{ mapped.emplace(path); }
+			catch(std::runtime_error const&)
+			{}
+
+			if(mapped.has_value())
+			{ return load<T>(std::move(*mapped)); }
+		}
+
 		auto file_deleter = [](FILE* f){ return fclose(f); };
 		std::unique_ptr<FILE, decltype(file_deleter)> src{fopen(path.c_str(), "rb")};
 		if(src == nullptr)
 		{
 			throw std::runtime_error{std::string{"Failed to open file "}.append(path)};
 		}
-		return load(src.get());
+		return load<T>(src.get());
 	}
 }
 
@@ -24,6 +24,30 @@ namespace
 
 		return anon::read_result{ret_val, ret_status};
 	}
+
+	struct chunked_buffer
+	{
+		explicit chunked_buffer(std::string_view sv, size_t chunk_size):
+			data{sv},
+			ptr{std::begin(data)},
+			chunk_size{chunk_size}
+		{}
+
+		std::string_view data;
+		char const* ptr;
+		size_t chunk_size;
+	};
+
+	anon::chunk_read_result read_chunk(chunked_buffer& buff)
+	{
+		auto const n = std::min(buff.chunk_size, static_cast<size_t>(std::end(buff.data) - buff.ptr));
+		if(n == 0)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::eof}; }
+
+		auto const ret = std::span{buff.ptr, n};
+		buff.ptr += n;
+		return anon::chunk_read_result{ret, anon::stream_status::ready};
+	}
 }
 
 TESTCASE(anon_load)
@@ -123,4 +147,207 @@ obj{
 	EXPECT_EQ(std::get<double>(obj["an_f64"]), 1.0);
 	EXPECT_EQ(std::size(std::get<std::vector<int32_t>>(obj["an_empty_array_1"])), 0);
 	EXPECT_EQ(std::size(std::get<std::vector<anon::object>>(obj["an_empty_array_2"])), 0);
-}
\ No newline at end of file
+}
+
+TESTCASE(anon_update_chunk)
+{
+	std::string_view const data{R"(obj{
+	a_string: str{this is a test with ; \\ and { } \}
+	an_array_of_i32: i32*{1\;2\;3\;\}
+\}blah)"};
+
+	auto ctxt = anon::create_parser_context();
+	auto const res = anon::update(data, *ctxt);
+	EXPECT_EQ(res.status, anon::parse_result::done);
+	EXPECT_EQ(data.substr(res.bytes_consumed), "blah");
+
+	auto obj = std::get<anon::object>(anon::take_result_and_reset(*ctxt));
+	EXPECT_EQ(std::get<std::string>(obj["a_string"]), R"(this is a test with ; \ and { } )");
+	EXPECT_EQ(std::size(std::get<std::vector<int32_t>>(obj["an_array_of_i32"])), 3);
+}
+
+TESTCASE(anon_update_chunk_incomplete)
+{
+	std::string_view const data{R"(obj{
+	a_string: str{foobar\}
+)"};
+
+	auto ctxt = anon::create_parser_context();
+	auto const res = anon::update(data, *ctxt);
+	EXPECT_EQ(res.status, anon::parse_result::more_data_needed);
+	EXPECT_EQ(res.bytes_consumed, std::size(data));
+}
+
+TESTCASE(anon_load_chunked_source)
+{
+	std::string_view const data{R"(obj{
+	a_string: str{this is a test with ; \\ and { } \}
+	an_array_of_objects: obj*{
+		foobar:str*{A\;B\;C\;\}\;
+		key_in_second_obj:str{Hello world\}\;
+	\}
+\}
+obj{
+	kaka: i32{123\}
+\})"};
+
+	for(size_t chunk_size = 1; chunk_size != std::size(data) + 1; ++chunk_size)
+	{
+		chunked_buffer buff{data, chunk_size};
+		anon::async_loader loader{buff};
+
+		auto obj_1 = loader.try_read_next<anon::object>();
+		REQUIRE_EQ(obj_1.has_value(), true);
+		EXPECT_EQ(std::get<std::string>((*obj_1)["a_string"]), R"(this is a test with ; \ and { } )");
+		auto& an_array_of_objects = std::get<std::vector<anon::object>>((*obj_1)["an_array_of_objects"]);
+		REQUIRE_EQ(std::size(an_array_of_objects), 2);
+		EXPECT_EQ(std::get<std::string>(an_array_of_objects[1]["key_in_second_obj"]), "Hello world");
+
+		auto obj_2 = loader.try_read_next<anon::object>();
+		REQUIRE_EQ(obj_2.has_value(), true);
+		EXPECT_EQ(std::get<int32_t>((*obj_2)["kaka"]), 123);
+	}
+}
+
+TESTCASE(anon_load_long_strings)
+{
+	std::string long_string;
+	for(size_t k = 0; k != 1000; ++k)
+	{
+		long_string += static_cast<char>('a' + k%26);
+		if(k%97 == 0)
+		{ long_string += "\\\\"; }
+	}
+
+	auto const data = std::string{"obj{a_long_key_name_for_testing: str{"}
+		.append(long_string)
+		.append("\\}\\}");
+
+	for(size_t chunk_size = 1; chunk_size != 70; ++chunk_size)
+	{
+		chunked_buffer buff{data, chunk_size};
+		auto obj = anon::load(buff);
+		auto const& str = std::get<std::string>(obj["a_long_key_name_for_testing"]);
+		EXPECT_EQ(std::size(str), 1011);
+		EXPECT_EQ(std::ranges::count(str, '\\'), 11);
+	}
+}
+
+TESTCASE(anon_load_null_character_in_value)
+{
+	auto const data = std::string{"obj{foo: str{abcdefghijklmnopqrstuvwxyz"}
+		.append(1, '\0')
+		.append("\\}\\}");
+
+	try
+	{
+		auto obj = anon::load(chunked_buffer{data, std::size(data)});
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+}
+
+TESTCASE(anon_load_unsorted_keys)
+{
+	auto obj = anon::load(buffer{R"(obj{c: i32{3\} a: i32{1\} b: i32{2\}\})"});
+	REQUIRE_EQ(std::size(obj), 3);
+	std::string keys;
+	for(auto const& item : obj)
+	{ keys += std::string_view{item.first}; }
+	EXPECT_EQ(keys, "abc");
+
+	try
+	{
+		auto obj = anon::load(buffer{R"(obj{a: i32{3\} a: i32{1\}\})"});
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+}
+
+TESTCASE(anon_load_interned_object)
+{
+	std::string_view src{R"(obj{
+key_b: i32{1\}
+key_a: obj{
+	nested: str{Hello\}
+\}
+key_c: obj*{
+	value: f64{0.5\}
+	\;
+	value: f64{1.5\}
+	\;
+\}
+\})"};
+
+	auto const obj = anon::load<anon::interned_object>(chunked_buffer{src, 7});
+	EXPECT_EQ(std::size(obj), 3);
+	EXPECT_EQ(std::get<int32_t>(obj[anon::interned_name{"key_b"}]), 1);
+	EXPECT_EQ(std::get<std::string>(std::get<anon::interned_object>(obj["key_a"])["nested"]), "Hello");
+
+	auto const& array = std::get<std::vector<anon::interned_object>>(obj["key_c"]);
+	REQUIRE_EQ(std::size(array), 2);
+	EXPECT_EQ(std::get<double>(array[1]["value"]), 1.5);
+
+	auto i = std::begin(obj);
+	EXPECT_EQ(std::string_view{i->first}, "key_a");
+	++i;
+	EXPECT_EQ(std::string_view{i->first}, "key_b");
+
+	auto const byte_wise = anon::load<anon::interned_object>(buffer{src});
+	EXPECT_EQ(byte_wise, obj);
+}
+
+TESTCASE(anon_load_pmr_object)
+{
+	std::string_view src{R"(obj{
+a_string: str{Hello, World\}
+an_array: i32*{1\;2\;3\;\}
+an_array_of_strings: str*{This is a long string, that does not fit in the small buffer\;Foo\;\}
+an_array_of_objects: obj*{
+	value: f64{0.5\}
+	\;
+	value: f64{1.5\}
+	\;
+\}
+an_object: obj{
+	nested: str{Another long string, that does not fit in the small buffer\}
+\}
+\})"};
+
+	std::array<std::byte, 4096> storage;
+	std::pmr::monotonic_buffer_resource arena{std::data(storage), std::size(storage),
+		std::pmr::null_memory_resource()};
+
+	// Any allocation that is not made from arena will fail
+	auto const old_default = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+	try
+	{
+		auto const obj = anon::load(chunked_buffer{src, 13}, arena);
+		std::pmr::set_default_resource(old_default);
+
+		EXPECT_EQ(obj.get_allocator().resource(), &arena);
+		EXPECT_EQ(std::size(obj), 5);
+		EXPECT_EQ(std::get<std::pmr::string>(obj["a_string"]), "Hello, World");
+		EXPECT_EQ(std::size(std::get<std::pmr::vector<int32_t>>(obj["an_array"])), 3);
+
+		auto const& strings = std::get<std::pmr::vector<std::pmr::string>>(obj["an_array_of_strings"]);
+		REQUIRE_EQ(std::size(strings), 2);
+		EXPECT_EQ(strings[0].get_allocator().resource(), &arena);
+		EXPECT_EQ(strings[1], "Foo");
+
+		auto const& objects = std::get<std::pmr::vector<anon::pmr_object>>(obj["an_array_of_objects"]);
+		REQUIRE_EQ(std::size(objects), 2);
+		EXPECT_EQ(objects[1].get_allocator().resource(), &arena);
+		EXPECT_EQ(std::get<double>(objects[1]["value"]), 1.5);
+
+		auto const& nested = std::get<anon::pmr_object>(obj["an_object"]);
+		EXPECT_EQ(std::get<std::pmr::string>(nested["nested"]).get_allocator().resource(), &arena);
+	}
+	catch(...)
+	{
+		std::pmr::set_default_resource(old_default);
+		throw;
+	}
+}
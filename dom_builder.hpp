@@ -0,0 +1,156 @@
+#ifndef ANON_DOMBUILDER_HPP
+#define ANON_DOMBUILDER_HPP
+
+/**
+ * \file dom_builder.hpp
+ *
+ * \brief Contains the definition of dom_builder
+ */
+
+#include "./object.hpp"
+
+#include <optional>
+#include <span>
+#include <stack>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace anon
+{
+	/**
+	 * \brief An event handler, that builds an object tree from the events reported by an
+	 * event_parser
+	 *
+	 * All values are allocated using the allocator passed to the constructor.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class Object>
+	class dom_builder
+	{
+	public:
+		using object_type = Object;
+		using key_type = typename Object::key_type;
+		using mapped_type = typename Object::mapped_type;
+		using allocator_type = typename Object::allocator_type;
+
+		explicit dom_builder(allocator_type const& alloc = {}):m_alloc{alloc}
+		{}
+
+		void on_key(std::string_view name)
+		{ m_key = key_type{name}; }
+
+		void on_begin_object()
+		{
+			if(std::size(m_nodes) == 0 && m_recycled.has_value())
+			{
+				m_recycled->clear();
+				m_nodes.push(node_type{std::move(m_key), std::move(*m_recycled)});
+				m_recycled.reset();
+				return;
+			}
+			m_nodes.push(node_type{std::move(m_key), Object{m_alloc}});
+		}
+
+		void on_end_object()
+		{ pop_node(); }
+
+		template<class T>
+		void on_begin_array(std::type_identity<T>)
+		{ m_nodes.push(node_type{std::move(m_key), array_of<T>(m_alloc)}); }
+
+		void on_end_array()
+		{ pop_node(); }
+
+		template<class T>
+		void on_scalar(T value)
+		{
+			if constexpr(std::is_same_v<T, std::string_view>)
+			{ add_value(node_type{std::move(m_key), typename Object::string_type(value, m_alloc)}); }
+			else
+			{ add_value(node_type{std::move(m_key), value}); }
+		}
+
+		template<class T>
+		void on_array_element(T value)
+		{
+			using element_type = std::conditional_t<std::is_same_v<T, std::string_view>, std::string, T>;
+			std::get<array_of<element_type>>(m_nodes.top().second).emplace_back(value);
+		}
+
+		template<class T>
+		void on_array_elements(std::span<T const> values)
+		{
+			auto& array = std::get<array_of<T>>(m_nodes.top().second);
+			array.insert(std::end(array), std::begin(values), std::end(values));
+		}
+
+		/**
+		 * \brief Moves the most recently completed value out of this dom_builder
+		 */
+		mapped_type take_result()
+		{ return std::move(m_result); }
+
+		/**
+		 * \brief Discards any partially built value
+		 *
+		 * \note Storage that has been allocated for the node stack is kept
+		 */
+		void reset()
+		{
+			while(!m_nodes.empty())
+			{ m_nodes.pop(); }
+			m_key = key_type{};
+		}
+
+		/**
+		 * \brief Hands obj back to this dom_builder, so its storage can be reused by the next
+		 * outermost object
+		 */
+		void recycle(Object&& obj)
+		{ m_recycled = std::move(obj); }
+
+	private:
+		using node_type = std::pair<key_type, mapped_type>;
+
+		// Maps element types from object::mapped_type to the corresponding array in mapped_type
+		template<class T>
+		using array_of = typename Object::template array_type<std::conditional_t<std::is_same_v<T, object>,
+			Object,
+			std::conditional_t<std::is_same_v<T, std::string>, typename Object::string_type, T>>>;
+
+		allocator_type m_alloc;
+		key_type m_key;
+		std::stack<node_type> m_nodes;
+		mapped_type m_result;
+		std::optional<Object> m_recycled;
+
+		void pop_node()
+		{
+			auto node = std::move(m_nodes.top());
+			m_nodes.pop();
+			add_value(std::move(node));
+		}
+
+		void add_value(node_type&& node)
+		{
+			if(std::size(m_nodes) == 0)
+			{
+				m_result = std::move(node.second);
+				return;
+			}
+
+			auto& parent = m_nodes.top().second;
+			if(auto obj = std::get_if<Object>(&parent); obj != nullptr)
+			{
+				obj->insert(std::move(node.first), std::move(node.second));
+				return;
+			}
+
+			std::get<array_of<object>>(parent).push_back(std::move(std::get<Object>(node.second)));
+		}
+	};
+}
+
+#endif
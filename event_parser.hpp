@@ -0,0 +1,673 @@
+#ifndef ANON_EVENTPARSER_HPP
+#define ANON_EVENTPARSER_HPP
+
+/**
+ * \file event_parser.hpp
+ *
+ * \brief Contains the definition of event_parser, and the event_handler concept
+ */
+
+#include "./type_info.hpp"
+#include "./variant_helper.hpp"
+#include "./number_parser.hpp"
+#include "./scanner.hpp"
+
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace anon
+{
+	/**
+	* \brief Holds the result after processing one byte
+	*
+	* \ingroup de-serialization
+	*/
+	enum class parse_result{done, more_data_needed};
+
+	/**
+	 * \brief Holds the result after processing a block of input
+	 *
+	 * \ingroup de-serialization
+	 */
+	struct update_result
+	{
+		/**
+		 * \brief The number of bytes that were consumed from the input
+		 */
+		size_t bytes_consumed;
+
+		/**
+		 * \brief The state of the parser after the last consumed byte
+		 */
+		parse_result status;
+	};
+
+	/**
+	 * \brief Specifies the events that an event_parser reports to its handler
+	 *
+	 * A handler must provide the following member functions:
+	 *
+	 * ```
+	 * void on_key(std::string_view name);
+	 * void on_begin_object();
+	 * void on_end_object();
+	 * template<class T> void on_begin_array(std::type_identity<T>);
+	 * void on_end_array();
+	 * void on_scalar(T value);
+	 * void on_array_element(T value);
+	 * ```
+	 *
+	 * on_key is called before the value of a property. Objects, including the elements of an array of
+	 * objects, are reported by on_begin_object and on_end_object, and the properties in between. The
+	 * element type passed to on_begin_array is the type of a single element, as it appears in
+	 * object::mapped_type. on_scalar and on_array_element are called with a number type, or with a
+	 * std::string_view for strings. A string_view is only valid during the call.
+	 *
+	 * Optionally, a handler may also provide
+	 *
+	 * ```
+	 * void on_array_elements(std::span<T const> values);
+	 * ```
+	 *
+	 * If it does, elements of number arrays may be reported in batches through this function, instead
+	 * of one by one through on_array_element.
+	 *
+	 * If on_key returns bool, a return value of false makes the parser skip the value of that
+	 * property. A skipped value is not reported to the handler, and only the type tag of the
+	 * property itself is validated. Everything within it is scanned for control sequences, without
+	 * decoding any keys or values.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class Handler>
+	concept event_handler = requires(Handler& handler, std::string_view str)
+	{
+		handler.on_key(str);
+		handler.on_begin_object();
+		handler.on_end_object();
+		handler.on_begin_array(std::type_identity<int32_t>{});
+		handler.on_end_array();
+		handler.on_scalar(int32_t{});
+		handler.on_scalar(str);
+		handler.on_array_element(int32_t{});
+		handler.on_array_element(str);
+	};
+
+	/**
+	 * \brief A parser that reports what it reads to a handler, rather than building an object
+	 *
+	 * Since no object is built, memory usage only depends on the nesting depth, and the size of the
+	 * largest single value. This makes it possible to process input that is larger than the
+	 * available memory. After the outermost value has been closed, the parser is ready to read the
+	 * next value.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	class event_parser
+	{
+	public:
+		explicit event_parser(Handler&& handler):m_handler{std::forward<Handler>(handler)}
+		{}
+
+		/**
+		* \brief Processes input, and reports any completed events to the handler
+		*
+		* \note If an error occurs during processing of input, an exception is thrown
+		*
+		* \return parse_result::done if the outermost value was closed, otherwise
+		*         parse_result::more_data_needed
+		*/
+		parse_result update(char input)
+		{ return process(input); }
+
+		/**
+		* \brief Processes input, and reports any completed events to the handler
+		*
+		* This function feeds all bytes in input to the parser, until the outermost value is closed,
+		* or there is no more input. Any bytes after the end of the outermost value are not consumed.
+		*
+		* \note If an error occurs during processing of input, an exception is thrown
+		*/
+		update_result update(std::span<char const> input);
+
+		/**
+		 * \brief Resets the parser to its initial state, so it can read another value
+		 */
+		void reset()
+		{
+			m_current_state = parser_state::init;
+			m_prev_state = parser_state::init;
+			m_buffer.clear();
+			m_frames.clear();
+			m_skip_next = false;
+		}
+
+		/**
+		 * \brief Returns the number of values that are currently open
+		 */
+		size_t level() const
+		{ return std::size(m_frames); }
+
+		/**
+		 * \brief Checks whether or not the parser is between two values, that is, no part of a
+		 * value has been read since the previous value was completed
+		 */
+		bool idle() const
+		{ return m_current_state == parser_state::init && std::size(m_frames) == 0; }
+
+		decltype(auto) handler()
+		{ return (m_handler); }
+
+		decltype(auto) handler() const
+		{ return (m_handler); }
+
+	private:
+		using value_types = object::mapped_type;
+
+		static constexpr auto object_array_index
+			= variant_helper::index_of<std::vector<object>, value_types>;
+
+		using element_reader = char const* (event_parser::*)(char const*, char const*);
+
+		struct frame
+		{
+			size_t type_index;
+			bool element_open;
+			element_reader read_elements;
+		};
+
+		struct skip_state
+		{
+			size_t depth;
+			bool in_value;
+			bool escape;
+			bool tag_ended;
+		};
+
+		parser_state m_current_state{parser_state::init};
+		parser_state m_prev_state{parser_state::init};
+		std::string m_buffer;
+		std::vector<frame> m_frames;
+		bool m_skip_next{false};
+		skip_state m_skip{};
+		Handler m_handler;
+
+		static constexpr bool is_whitespace(char val)
+		{
+			return val >= '\0' && val<= ' ';
+		}
+
+		template<class T>
+		auto decode() const
+		{
+			if constexpr(std::is_same_v<T, std::string>)
+			{ return std::string_view{m_buffer}; }
+			else
+			{ return parse_number<T>(m_buffer); }
+		}
+
+		static size_t type_index(std::string_view name);
+
+		[[gnu::always_inline]] inline parse_result process(char input);
+
+		void begin_value();
+		void end_value();
+		void next_element();
+		void on_key();
+		void begin_skip(size_t index);
+		bool skip(char val);
+
+		template<class T>
+		char const* read_elements(char const* ptr, char const* end);
+
+		template<class T>
+		void emit_elements(std::span<T const> values);
+	};
+
+	template<class Handler>
+	event_parser(Handler&) -> event_parser<Handler&>;
+
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	size_t event_parser<Handler>::type_index(std::string_view name)
+	{
+		auto const index = variant_helper::find_type<value_types>([name]<class T>(variant_helper::empty<T>){
+			return name == type_info<T>::name();
+		});
+
+		if(index == std::variant_npos)
+		{
+			throw std::runtime_error{std::string{"Unsupported type '"}.append(name).append("'")};
+		}
+		return index;
+	}
+
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	void event_parser<Handler>::begin_value()
+	{
+		auto const index = type_index(m_buffer);
+		m_buffer.clear();
+		if(m_skip_next)
+		{
+			begin_skip(index);
+			return;
+		}
+
+		m_frames.push_back(frame{index, false, nullptr});
+
+		variant_helper::on_type_index<value_types>(index, [this]<class T>(variant_helper::empty<T>){
+			if constexpr(std::is_same_v<T, object>)
+			{ m_handler.on_begin_object(); }
+			else
+			if constexpr(std::is_same_v<T, std::string> || !std::ranges::range<T>)
+			{}
+			else
+			{
+				using element_type = typename T::value_type;
+				if constexpr(std::is_arithmetic_v<element_type>)
+				{ m_frames.back().read_elements = &event_parser::read_elements<element_type>; }
+				m_handler.on_begin_array(std::type_identity<element_type>{});
+			}
+			m_current_state = type_info<T>::parser_init_state();
+		});
+	}
+
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	void event_parser<Handler>::end_value()
+	{
+		auto const current = m_frames.back();
+		m_frames.pop_back();
+
+		variant_helper::on_type_index<value_types>(current.type_index, [this, current]<class T>(variant_helper::empty<T>){
+			if constexpr(std::is_same_v<T, object>)
+			{ m_handler.on_end_object(); }
+			else
+			if constexpr(std::is_same_v<T, std::vector<object>>)
+			{
+				if(current.element_open)
+				{ throw std::runtime_error{"Non-terminated array element"}; }
+				m_handler.on_end_array();
+			}
+			else
+			if constexpr(std::is_same_v<T, std::string> || !std::ranges::range<T>)
+			{ m_handler.on_scalar(decode<T>()); }
+			else
+			{
+				if(std::size(m_buffer) != 0)
+				{ throw std::runtime_error{std::string{"Non-terminated array element "}.append(m_buffer)}; }
+				m_handler.on_end_array();
+			}
+		});
+		m_buffer.clear();
+	}
+
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	void event_parser<Handler>::next_element()
+	{
+		auto& current = m_frames.back();
+		if(current.type_index == object_array_index)
+		{
+			if(!current.element_open)
+			{ m_handler.on_begin_object(); }
+			m_handler.on_end_object();
+			current.element_open = false;
+			return;
+		}
+
+		variant_helper::on_type_index<value_types>(current.type_index, [this]<class T>(variant_helper::empty<T>){
+			if constexpr(std::is_same_v<T, std::string> || !std::ranges::range<T>
+				|| std::is_same_v<T, object> || std::is_same_v<T, std::vector<object>>)
+			{ throw std::runtime_error{"Multiple values require an array"}; }
+			else
+			{ m_handler.on_array_element(decode<typename T::value_type>()); }
+		});
+		m_buffer.clear();
+	}
+
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	template<class T>
+	char const* event_parser<Handler>::read_elements(char const* ptr, char const* end)
+	{
+		// Decode all elements that are terminated by `\;` within the input, without copying them to
+		// the buffer. Anything else is left to the state machine.
+		std::array<T, 256> values;
+		size_t n = 0;
+		while(true)
+		{
+			auto const element_end = scanner::find_value_delimiter(ptr, end);
+			if(end - element_end < 2 || *element_end != '\\' || element_end[1] != ';')
+			{ break; }
+
+			values[n] = parse_number<T>(std::string_view{ptr, element_end});
+			++n;
+			ptr = element_end + 2;
+			if(n == std::size(values))
+			{
+				emit_elements(std::span<T const>{std::data(values), n});
+				n = 0;
+			}
+		}
+
+		if(n != 0)
+		{ emit_elements(std::span<T const>{std::data(values), n}); }
+		return ptr;
+	}
+
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	template<class T>
+	void event_parser<Handler>::emit_elements(std::span<T const> values)
+	{
+		if constexpr(requires{ m_handler.on_array_elements(values); })
+		{ m_handler.on_array_elements(values); }
+		else
+		{
+			for(auto item : values)
+			{ m_handler.on_array_element(item); }
+		}
+	}
+
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	void event_parser<Handler>::on_key()
+	{
+		if(std::size(m_frames) != 0)
+		{
+			auto& current = m_frames.back();
+			if(current.type_index == object_array_index && !current.element_open)
+			{
+				m_handler.on_begin_object();
+				current.element_open = true;
+			}
+		}
+		if constexpr(std::is_same_v<decltype(m_handler.on_key(std::string_view{})), bool>)
+		{ m_skip_next = !m_handler.on_key(std::string_view{m_buffer}); }
+		else
+		{ m_handler.on_key(std::string_view{m_buffer}); }
+		m_buffer.clear();
+	}
+
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	void event_parser<Handler>::begin_skip(size_t index)
+	{
+		auto const is_container = index == object_array_index
+			|| index == variant_helper::index_of<object, value_types>;
+		m_skip_next = false;
+		m_skip = skip_state{is_container? size_t{1} : size_t{0}, !is_container, false, false};
+		m_current_state = parser_state::skip;
+	}
+
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	bool event_parser<Handler>::skip(char val)
+	{
+		// Outside values, m_buffer holds the most recent type tag candidate, which is needed to
+		// tell objects from other values, when `{` is found
+		if(m_skip.escape)
+		{
+			m_skip.escape = false;
+			if(val != '}')
+			{ return false; }
+
+			if(m_skip.in_value)
+			{ m_skip.in_value = false; }
+			else
+			{ --m_skip.depth; }
+			return m_skip.depth == 0;
+		}
+
+		if(val == '\\')
+		{
+			m_skip.escape = true;
+			return false;
+		}
+
+		if(m_skip.in_value)
+		{ return false; }
+
+		if(val == '{')
+		{
+			if(m_buffer == type_info<object>::name() || m_buffer == type_info<std::vector<object>>::name())
+			{ ++m_skip.depth; }
+			else
+			{ m_skip.in_value = true; }
+			m_buffer.clear();
+			m_skip.tag_ended = false;
+			return false;
+		}
+
+		if(val == ':')
+		{
+			m_buffer.clear();
+			m_skip.tag_ended = false;
+		}
+		else
+		if(is_whitespace(val))
+		{ m_skip.tag_ended = true; }
+		else
+		{
+			if(m_skip.tag_ended)
+			{
+				m_buffer.clear();
+				m_skip.tag_ended = false;
+			}
+			m_buffer += val;
+		}
+		return false;
+	}
+
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	parse_result event_parser<Handler>::process(char input)
+	{
+		auto const val = input;
+
+		switch(m_current_state)
+		{
+			case parser_state::init:
+				if(!is_whitespace(val))
+				{
+					m_current_state = parser_state::type_tag;
+					m_buffer += val;
+				}
+				break;
+
+			case parser_state::type_tag:
+				switch(val)
+				{
+					case '{':
+						begin_value();
+						break;
+
+					default:
+						if(is_whitespace(val))
+						{
+							m_current_state = parser_state::after_type_tag;
+						}
+						else
+						{ m_buffer += val; }
+				}
+				break;
+
+			case parser_state::after_type_tag:
+				switch(val)
+				{
+					case '{':
+						begin_value();
+						break;
+
+					default:
+						if(!is_whitespace(val))
+						{
+							throw std::runtime_error{"Junk after type tag"};
+						}
+				}
+				break;
+
+			case parser_state::key:
+				switch(val)
+				{
+					case ':':
+						m_current_state = parser_state::init;
+						on_key();
+						break;
+
+					case '\\':
+						m_prev_state = m_current_state;
+						m_current_state = parser_state::ctrl_char;
+						break;
+
+					default:
+						if(is_whitespace(val))
+						{
+							if(std::size(m_buffer) != 0)
+							{
+								m_current_state = parser_state::after_key;
+							}
+						}
+						else
+						{
+							m_buffer += val;
+						}
+				}
+				break;
+
+			case parser_state::after_key:
+				switch(val)
+				{
+					case ':':
+						m_current_state = parser_state::init;
+						on_key();
+						break;
+
+					default:
+						if(!is_whitespace(val))
+						{
+							throw std::runtime_error{"Junk after key"};
+						}
+				}
+				break;
+
+			case parser_state::value:
+				switch(val)
+				{
+					case '\\':
+						m_prev_state = m_current_state;
+						m_current_state = parser_state::ctrl_char;
+						break;
+
+					default:
+						if(val == '\0')
+						{ throw std::runtime_error{"Null character detected in input stream"}; }
+						m_buffer += val;
+				}
+				break;
+
+			case parser_state::ctrl_char:
+				switch(val)
+				{
+					case '}':
+						if(std::size(m_frames) == 0)
+						{
+							throw std::runtime_error{"No value here to end"};
+						}
+
+						end_value();
+						if(std::size(m_frames) == 0)
+						{
+							m_current_state = parser_state::init;
+							return parse_result::done;
+						}
+						m_current_state = parser_state::key;
+						break;
+
+					case ';':
+						next_element();
+						m_current_state = m_prev_state;
+						break;
+
+					default:
+						if(val == '\0')
+						{ throw std::runtime_error{"Null character detected in input stream"}; }
+						m_buffer += val;
+						m_current_state = m_prev_state;
+				}
+				break;
+
+			case parser_state::skip:
+				if(skip(val))
+				{
+					m_buffer.clear();
+					m_current_state = parser_state::key;
+				}
+		}
+		return parse_result::more_data_needed;
+	}
+
+	template<class Handler>
+	requires(event_handler<std::remove_reference_t<Handler>>)
+	update_result event_parser<Handler>::update(std::span<char const> input)
+	{
+		auto const begin = std::data(input);
+		auto const end = begin + std::size(input);
+		auto ptr = begin;
+		while(ptr != end)
+		{
+			// Characters that do not affect the state can be appended to the buffer in one go
+			switch(m_current_state)
+			{
+				case parser_state::value:
+				{
+					// Complete elements of number arrays can be decoded directly from the input
+					if(auto const read_elements = m_frames.back().read_elements;
+						read_elements != nullptr && std::size(m_buffer) == 0)
+					{ ptr = (this->*read_elements)(ptr, end); }
+
+					auto const run_end = scanner::find_value_delimiter(ptr, end);
+					m_buffer.append(ptr, run_end);
+					ptr = run_end;
+					break;
+				}
+
+				case parser_state::key:
+				{
+					auto const run_end = scanner::find_key_delimiter(ptr, end);
+					m_buffer.append(ptr, run_end);
+					ptr = run_end;
+					break;
+				}
+
+				case parser_state::skip:
+					// Only control sequences matter within the contents of a skipped value
+					if(m_skip.in_value && !m_skip.escape)
+					{ ptr = scanner::find_value_delimiter(ptr, end); }
+					break;
+
+				default:
+					break;
+			}
+
+			if(ptr == end)
+			{ break; }
+
+			auto const res = process(*ptr);
+			++ptr;
+			if(res == parse_result::done)
+			{ return update_result{static_cast<size_t>(ptr - begin), parse_result::done}; }
+		}
+		return update_result{std::size(input), parse_result::more_data_needed};
+	}
+}
+
+#endif
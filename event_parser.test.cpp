@@ -0,0 +1,270 @@
+//@	{"target":{"name":"event_parser.test"}}
+
+#include "./event_parser.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct event_recorder
+	{
+		std::string events;
+
+		void on_key(std::string_view name)
+		{ events.append("key ").append(name).append("\n"); }
+
+		void on_begin_object()
+		{ events.append("begin_object\n"); }
+
+		void on_end_object()
+		{ events.append("end_object\n"); }
+
+		template<class T>
+		void on_begin_array(std::type_identity<T>)
+		{ events.append("begin_array ").append(anon::type_info<T>::name()).append("\n"); }
+
+		void on_end_array()
+		{ events.append("end_array\n"); }
+
+		template<class T>
+		void on_scalar(T value)
+		{ events.append("scalar ").append(to_string(value)).append("\n"); }
+
+		template<class T>
+		void on_array_element(T value)
+		{ events.append("element ").append(to_string(value)).append("\n"); }
+
+		static std::string to_string(std::string_view value)
+		{ return std::string{value}; }
+
+		template<class T>
+		static std::string to_string(T value)
+		{ return std::to_string(value); }
+	};
+
+	struct summer
+	{
+		double sum{0.0};
+		size_t count{0};
+
+		void on_key(std::string_view){}
+		void on_begin_object(){}
+		void on_end_object(){}
+
+		template<class T>
+		void on_begin_array(std::type_identity<T>){}
+
+		void on_end_array(){}
+
+		void on_scalar(std::string_view){}
+
+		template<class T>
+		void on_scalar(T value)
+		{
+			sum += static_cast<double>(value);
+			++count;
+		}
+
+		void on_array_element(std::string_view){}
+
+		template<class T>
+		void on_array_element(T value)
+		{ on_scalar(value); }
+	};
+
+	static_assert(anon::event_handler<event_recorder>);
+	static_assert(anon::event_handler<summer>);
+}
+
+TESTCASE(anon_event_parser_events)
+{
+	std::string_view const src{R"(obj{
+an_int: i32{1\}
+a_string: str{Hello, \\World\}
+numbers: f64*{1.5\;2.5\;\}
+objects: obj*{
+	value: u32{2\}
+	\;
+	\;
+\}
+nested: obj{
+	empty: str*{\}
+\}
+\})"};
+
+	anon::event_parser parser{event_recorder{}};
+	auto const res = parser.update(std::span{std::data(src), std::size(src)});
+	EXPECT_EQ(res.status, anon::parse_result::done);
+	EXPECT_EQ(res.bytes_consumed, std::size(src));
+	EXPECT_EQ(parser.level(), 0);
+	EXPECT_EQ(parser.handler().events, R"(begin_object
+key an_int
+scalar 1
+key a_string
+scalar Hello, \World
+key numbers
+begin_array f64
+element 1.500000
+element 2.500000
+end_array
+key objects
+begin_array obj
+begin_object
+key value
+scalar 2
+end_object
+begin_object
+end_object
+end_array
+key nested
+begin_object
+key empty
+begin_array str
+end_array
+end_object
+end_object
+)");
+}
+
+TESTCASE(anon_event_parser_aggregate)
+{
+	std::string const src{R"(obj{a: i32{1\} b: f64*{2\;3\;4\;\} c: obj{d: u64{5\} e: str{6\}\}\})"};
+
+	summer handler;
+	anon::event_parser parser{handler};
+	for(auto item : src)
+	{
+		if(parser.update(item) == anon::parse_result::done)
+		{ break; }
+	}
+
+	EXPECT_EQ(handler.count, 5);
+	EXPECT_EQ(handler.sum, 15.0);
+}
+
+TESTCASE(anon_event_parser_multiple_values)
+{
+	std::string_view const src{R"(obj{a: i32{1\}\} obj{a: i32{2\}\}obj{a: i32{3\}\})"};
+
+	anon::event_parser parser{summer{}};
+	std::span input{std::data(src), std::size(src)};
+	size_t values = 0;
+	while(std::size(input) != 0)
+	{
+		auto const res = parser.update(input);
+		if(res.status == anon::parse_result::done)
+		{ ++values; }
+		input = input.subspan(res.bytes_consumed);
+	}
+
+	EXPECT_EQ(values, 3);
+	EXPECT_EQ(parser.handler().sum, 6.0);
+}
+
+TESTCASE(anon_event_parser_errors)
+{
+	for(auto const src : {R"(obj{a: i32{1\;2\}\})", R"(obj{a: i32*{1\;2\}\})",
+		R"(obj{a: obj*{b: i32{1\}\}\})", R"(obj{a: foo{1\}\})", R"(obj{a b: i32{1\}\})"})
+	{
+		anon::event_parser parser{summer{}};
+		try
+		{
+			std::string_view const str{src};
+			parser.update(std::span{std::data(str), std::size(str)});
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+}
+
+namespace
+{
+	struct batch_collector
+	{
+		std::vector<double> values;
+		size_t batches{0};
+		size_t ends{0};
+
+		void on_key(std::string_view){}
+		void on_begin_object(){}
+		void on_end_object(){}
+
+		template<class T>
+		void on_begin_array(std::type_identity<T>){}
+
+		void on_end_array()
+		{ ++ends; }
+
+		template<class T>
+		void on_scalar(T){}
+
+		template<class T>
+		void on_array_element(T value)
+		{
+			if constexpr(!std::is_same_v<T, std::string_view>)
+			{ values.push_back(value); }
+		}
+
+		void on_array_elements(std::span<double const> items)
+		{
+			values.insert(std::end(values), std::begin(items), std::end(items));
+			++batches;
+		}
+	};
+}
+
+TESTCASE(anon_event_parser_number_array_batches)
+{
+	std::string src{"obj{values: f64*{"};
+	std::vector<double> expected;
+	for(size_t k = 0; k != 1000; ++k)
+	{
+		expected.push_back(0.25*static_cast<double>(k));
+		src.append(std::to_string(expected.back())).append("\\;");
+	}
+	src.append("\\}\\}");
+
+	{
+		anon::event_parser parser{batch_collector{}};
+		auto const res = parser.update(std::span{std::data(src), std::size(src)});
+		EXPECT_EQ(res.status, anon::parse_result::done);
+		EXPECT_EQ(parser.handler().values, expected);
+		EXPECT_EQ(parser.handler().batches, 4);
+		EXPECT_EQ(parser.handler().ends, 1);
+	}
+
+	for(size_t chunk_size : {1, 2, 3, 7, 64, 1000})
+	{
+		anon::event_parser parser{batch_collector{}};
+		std::span input{std::data(src), std::size(src)};
+		while(std::size(input) != 0)
+		{
+			auto const n = std::min(chunk_size, std::size(input));
+			auto const res = parser.update(input.first(n));
+			input = input.subspan(res.bytes_consumed);
+		}
+		EXPECT_EQ(parser.handler().values, expected);
+		EXPECT_EQ(parser.handler().ends, 1);
+	}
+}
+
+TESTCASE(anon_event_parser_number_array_errors)
+{
+	for(auto const src : {R"(obj{a: i32*{1\;2x\;\}\})", R"(obj{a: i32*{1\;4294967296\;\}\})",
+		R"(obj{a: u32*{1\;-1\;\}\})", R"(obj{a: f32*{1\;\;\}\})"})
+	{
+		anon::event_parser parser{summer{}};
+		try
+		{
+			std::string_view const str{src};
+			parser.update(std::span{std::data(str), std::size(str)});
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+}
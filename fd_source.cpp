@@ -0,0 +1,44 @@
+//@	{"target":{"name":"fd_source.o"}}
+
+#include "./fd_source.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+anon::chunk_read_result anon::fd_source::read()
+{
+	while(true)
+	{
+		auto const n = ::read(m_fd, m_buffer.get(), m_capacity);
+		if(n == -1)
+		{
+			if(errno == EINTR)
+			{ continue; }
+
+			if(errno == EAGAIN || errno == EWOULDBLOCK)
+			{ return chunk_read_result{std::span<char const>{}, stream_status::blocking}; }
+
+			throw std::runtime_error{std::string{"Failed to read data: "}.append(strerror(errno))};
+		}
+
+		if(n == 0)
+		{ return chunk_read_result{std::span<char const>{}, stream_status::eof}; }
+
+		return chunk_read_result{std::span{m_buffer.get(), static_cast<size_t>(n)}, stream_status::ready};
+	}
+}
+
+void anon::make_non_blocking(int fd)
+{
+	auto const flags = ::fcntl(fd, F_GETFL);
+	if(flags == -1 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+	{
+		throw std::runtime_error{std::string{"Failed to make file descriptor non-blocking: "}
+			.append(strerror(errno))};
+	}
+}
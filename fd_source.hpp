@@ -0,0 +1,77 @@
+//@	{"dependencies_extra":[{"ref":"./fd_source.o","rel":"implementation"}]}
+
+#ifndef ANON_FDSOURCE_HPP
+#define ANON_FDSOURCE_HPP
+
+/**
+ * \file fd_source.hpp
+ *
+ * \brief Contains the definition of fd_source
+ */
+
+#include "./source.hpp"
+
+#include <memory>
+#include <span>
+
+namespace anon
+{
+	/**
+	 * \brief A chunked source that reads from a file descriptor
+	 *
+	 * Data is read into a buffer owned by the source. If the file descriptor is in non-blocking
+	 * mode, and no data is available, read_chunk reports stream_status::blocking, so the source can
+	 * be used together with async_loader, record_reader, or a reactor.
+	 *
+	 * \note The file descriptor is not owned by the source, and is not closed by it
+	 *
+	 * \ingroup de-serialization
+	 */
+	class fd_source
+	{
+	public:
+		explicit fd_source(int fd, size_t buffer_size = 4096):
+			m_fd{fd},
+			m_buffer{std::make_unique<char[]>(buffer_size)},
+			m_capacity{buffer_size}
+		{}
+
+		/**
+		 * \brief Returns the file descriptor associated with this source
+		 */
+		int fd() const
+		{ return m_fd; }
+
+		/**
+		 * \brief Reads as much data as fits in the buffer, and returns it
+		 *
+		 * \note The previously returned data is overwritten
+		 */
+		chunk_read_result read();
+
+	private:
+		int m_fd;
+		std::unique_ptr<char[]> m_buffer;
+		size_t m_capacity;
+	};
+
+	/**
+	 * \brief Reads the data that is currently available from src
+	 *
+	 * \note If reading fails for other reasons than the file descriptor being non-blocking, an
+	 * exception is thrown
+	 *
+	 * \ingroup de-serialization
+	 */
+	inline chunk_read_result read_chunk(fd_source& src)
+	{ return src.read(); }
+
+	/**
+	 * \brief Puts fd in non-blocking mode
+	 *
+	 * \ingroup de-serialization
+	 */
+	void make_non_blocking(int fd);
+}
+
+#endif
@@ -0,0 +1,49 @@
+//@	{"target":{"name":"fd_source.test"}}
+
+#include "./fd_source.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <string_view>
+
+#include <unistd.h>
+
+TESTCASE(anon_fd_source_read)
+{
+	int fds[2];
+	REQUIRE_EQ(::pipe(fds), 0);
+	anon::make_non_blocking(fds[0]);
+
+	anon::fd_source src{fds[0], 4};
+	EXPECT_EQ(src.fd(), fds[0]);
+	EXPECT_EQ(read_chunk(src).status, anon::stream_status::blocking);
+
+	std::string_view const data{"Hello, World"};
+	REQUIRE_EQ(::write(fds[1], std::data(data), std::size(data)), static_cast<ssize_t>(std::size(data)));
+	::close(fds[1]);
+
+	std::string result;
+	while(true)
+	{
+		auto const res = read_chunk(src);
+		if(res.status == anon::stream_status::eof)
+		{ break; }
+		REQUIRE_EQ(res.status, anon::stream_status::ready);
+		EXPECT_EQ(std::size(res.data) <= 4, true);
+		result.append(std::data(res.data), std::size(res.data));
+	}
+	EXPECT_EQ(result, data);
+	::close(fds[0]);
+}
+
+TESTCASE(anon_fd_source_bad_fd)
+{
+	anon::fd_source src{-1};
+	try
+	{
+		(void)read_chunk(src);
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+}
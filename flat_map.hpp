@@ -0,0 +1,251 @@
+#ifndef ANON_FLATMAP_HPP
+#define ANON_FLATMAP_HPP
+
+/**
+ * \file flat_map.hpp
+ *
+ * \brief Contains the definition of flat_map
+ */
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace anon
+{
+	/**
+	 * \brief Tag type used to indicate that input is already sorted, and contains no duplicates
+	 *
+	 * \ingroup objects
+	 */
+	struct sorted_unique_t
+	{
+		explicit sorted_unique_t() = default;
+	};
+
+	/**
+	 * \brief Tag used to indicate that input is already sorted, and contains no duplicates
+	 *
+	 * \ingroup objects
+	 */
+	inline constexpr sorted_unique_t sorted_unique{};
+
+	/**
+	 * \brief An associative container that stores its elements sorted in a contiguous array
+	 *
+	 * This class provides the subset of the `std::map` interface that is needed by object. Since
+	 * elements are stored in a `std::vector`, lookups are cache friendly, and each element does not
+	 * require a separate allocation. Inserting elements in sorted order is amortized O(1), while
+	 * inserting elements elsewhere is O(N).
+	 *
+	 * \note Unlike `std::map`, any insertion may invalidate iterators and references to elements
+	 *
+	 * \note The key of an element must not be modified through an iterator
+	 *
+	 * \ingroup objects
+	 */
+	template<class Key, class Value, class Compare = std::less<>,
+		class Allocator = std::allocator<std::pair<Key, Value>>>
+	class flat_map
+	{
+	public:
+		using key_type = Key;
+		using mapped_type = Value;
+		using value_type = std::pair<Key, Value>;
+		using allocator_type = Allocator;
+		using iterator = typename std::vector<value_type, Allocator>::iterator;
+		using const_iterator = typename std::vector<value_type, Allocator>::const_iterator;
+
+		flat_map() = default;
+
+		/**
+		 * \brief Constructs an empty flat_map, that allocates its elements using alloc
+		 */
+		explicit flat_map(Allocator const& alloc):m_items{alloc}
+		{}
+
+		/**
+		 * \brief Copies other, but allocates the elements using alloc
+		 */
+		explicit flat_map(flat_map const& other, Allocator const& alloc):m_items{other.m_items, alloc}
+		{}
+
+		/**
+		 * \brief Moves other, but allocates the elements using alloc
+		 *
+		 * \note If alloc is not equal to the allocator of other, elements are moved one by one
+		 */
+		explicit flat_map(flat_map&& other, Allocator const& alloc):
+			m_items{std::move(other.m_items), alloc}
+		{}
+
+		/**
+		 * \brief Constructs a flat_map from items, that are already sorted by key
+		 *
+		 * \note If items are not sorted, or there are duplicated keys, an exception is thrown
+		 */
+		explicit flat_map(sorted_unique_t, std::vector<value_type, Allocator>&& items):
+			m_items{std::move(items)}
+		{
+			if(std::ranges::adjacent_find(m_items, [](auto const& a, auto const& b) {
+				return !Compare{}(a.first, b.first);
+			}) != std::end(m_items))
+			{ throw std::runtime_error{"Input is not sorted, or contains duplicated keys"}; }
+		}
+
+		/**
+		 * \brief Inserts item, unless there already is an element with the same key
+		 *
+		 * \return An iterator to the element with the same key as item, and true if item was
+		 * inserted
+		 */
+		std::pair<iterator, bool> insert(value_type&& item)
+		{
+			if(std::size(m_items) == 0 || Compare{}(m_items.back().first, item.first))
+			{
+				m_items.push_back(std::move(item));
+				return std::pair{std::prev(std::end(m_items)), true};
+			}
+
+			auto const i = lower_bound(item.first);
+			if(!Compare{}(item.first, i->first))
+			{ return std::pair{i, false}; }
+
+			return std::pair{m_items.insert(i, std::move(item)), true};
+		}
+
+		template<class P>
+		requires(std::is_constructible_v<value_type, P&&>)
+		std::pair<iterator, bool> insert(P&& item)
+		{
+			return insert(value_type{std::forward<P>(item)});
+		}
+
+		/**
+		 * \brief Inserts a new element with key key, or updates the value of an existing element
+		 */
+		template<class T>
+		std::pair<iterator, bool> insert_or_assign(key_type&& key, T&& val)
+		{
+			if(std::size(m_items) == 0 || Compare{}(m_items.back().first, key))
+			{
+				m_items.emplace_back(std::move(key), std::forward<T>(val));
+				return std::pair{std::prev(std::end(m_items)), true};
+			}
+
+			auto const i = lower_bound(key);
+			if(!Compare{}(key, i->first))
+			{
+				i->second = std::forward<T>(val);
+				return std::pair{i, false};
+			}
+
+			return std::pair{m_items.emplace(i, std::move(key), std::forward<T>(val)), true};
+		}
+
+		/**
+		 * \name find
+		 *
+		 * \brief Looks up the element with key key
+		 */
+		///@{
+		template<class K>
+		iterator find(K const& key)
+		{
+			auto const i = lower_bound(key);
+			return i != std::end(m_items) && !Compare{}(key, i->first)? i : std::end(m_items);
+		}
+
+		template<class K>
+		const_iterator find(K const& key) const
+		{
+			auto const i = lower_bound(key);
+			return i != std::end(m_items) && !Compare{}(key, i->first)? i : std::end(m_items);
+		}
+		///@}
+
+		/**
+		 * \brief Checks whether or not there is an element with key key
+		 */
+		template<class K>
+		bool contains(K const& key) const
+		{ return find(key) != std::end(m_items); }
+
+		/**
+		 * \brief Removes the element at pos
+		 *
+		 * \return An iterator to the element after the removed element
+		 */
+		iterator erase(const_iterator pos)
+		{ return m_items.erase(pos); }
+
+		/**
+		 * \brief Returns the number of elements
+		 */
+		size_t size() const
+		{ return std::size(m_items); }
+
+		/**
+		 * \brief Reserves space for n elements
+		 */
+		void reserve(size_t n)
+		{ m_items.reserve(n); }
+
+		/**
+		 * \brief Removes all elements, but keeps the allocated storage
+		 */
+		void clear()
+		{ m_items.clear(); }
+
+		/**
+		 * \brief Returns the allocator used for elements
+		 */
+		allocator_type get_allocator() const
+		{ return m_items.get_allocator(); }
+
+		/**
+		 * \name Iterator access
+		 */
+		///@{
+		auto begin() const
+		{ return std::begin(m_items); }
+
+		auto begin()
+		{ return std::begin(m_items); }
+
+		auto end() const
+		{ return std::end(m_items); }
+
+		auto end()
+		{ return std::end(m_items); }
+		///@}
+
+		auto operator<=>(flat_map const&) const = default;
+
+	private:
+		std::vector<value_type, Allocator> m_items;
+
+		template<class K>
+		iterator lower_bound(K const& key)
+		{
+			return std::lower_bound(std::begin(m_items), std::end(m_items), key,
+				[](value_type const& item, K const& key) {
+					return Compare{}(item.first, key);
+				});
+		}
+
+		template<class K>
+		const_iterator lower_bound(K const& key) const
+		{
+			return std::lower_bound(std::begin(m_items), std::end(m_items), key,
+				[](value_type const& item, K const& key) {
+					return Compare{}(item.first, key);
+				});
+		}
+	};
+}
+
+#endif
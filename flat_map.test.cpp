@@ -0,0 +1,89 @@
+//@	{"target":{"name":"flat_map.test"}}
+
+#include "./flat_map.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <string>
+
+TESTCASE(anon_flat_map_insert)
+{
+	anon::flat_map<std::string, int> map;
+
+	EXPECT_EQ(map.insert(std::pair{std::string{"b"}, 2}).second, true);
+	EXPECT_EQ(map.insert(std::pair{std::string{"d"}, 4}).second, true);
+	EXPECT_EQ(map.insert(std::pair{std::string{"a"}, 1}).second, true);
+	EXPECT_EQ(map.insert(std::pair{std::string{"c"}, 3}).second, true);
+
+	auto const res = map.insert(std::pair{std::string{"c"}, 5});
+	EXPECT_EQ(res.second, false);
+	EXPECT_EQ(res.first->second, 3);
+
+	REQUIRE_EQ(std::size(map), 4);
+	std::string keys;
+	for(auto const& item : map)
+	{ keys += item.first; }
+	EXPECT_EQ(keys, "abcd");
+}
+
+TESTCASE(anon_flat_map_insert_or_assign)
+{
+	anon::flat_map<std::string, int> map;
+	map.insert_or_assign("b", 2);
+	map.insert_or_assign("a", 1);
+	EXPECT_EQ(map.insert_or_assign("b", 3).second, false);
+
+	REQUIRE_EQ(std::size(map), 2);
+	EXPECT_EQ(map.find(std::string_view{"b"})->second, 3);
+	EXPECT_EQ(std::begin(map)->first, "a");
+}
+
+TESTCASE(anon_flat_map_find)
+{
+	anon::flat_map<std::string, int> map;
+	map.insert_or_assign("foo", 1);
+	map.insert_or_assign("bar", 2);
+
+	EXPECT_EQ(map.contains(std::string_view{"foo"}), true);
+	EXPECT_EQ(map.contains(std::string_view{"bar"}), true);
+	EXPECT_EQ(map.contains(std::string_view{"kaka"}), false);
+	EXPECT_EQ(map.find(std::string_view{"kaka"}) == std::end(map), true);
+	EXPECT_EQ(map.find(std::string_view{"zzz"}) == std::end(map), true);
+}
+
+TESTCASE(anon_flat_map_erase)
+{
+	anon::flat_map<std::string, int> map;
+	map.insert_or_assign("a", 1);
+	map.insert_or_assign("b", 2);
+	map.insert_or_assign("c", 3);
+
+	auto const i = map.erase(map.find(std::string_view{"b"}));
+	EXPECT_EQ(i->first, "c");
+	EXPECT_EQ(std::size(map), 2);
+	EXPECT_EQ(map.contains(std::string_view{"b"}), false);
+}
+
+TESTCASE(anon_flat_map_sorted_unique)
+{
+	using map_type = anon::flat_map<std::string, int>;
+	map_type map{anon::sorted_unique, std::vector<map_type::value_type>{{"a", 1}, {"b", 2}, {"c", 3}}};
+	EXPECT_EQ(std::size(map), 3);
+	EXPECT_EQ(map.find(std::string_view{"b"})->second, 2);
+
+	try
+	{
+		map_type map{anon::sorted_unique, std::vector<map_type::value_type>{{"b", 1}, {"a", 2}}};
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+
+	try
+	{
+		map_type map{anon::sorted_unique, std::vector<map_type::value_type>{{"a", 1}, {"a", 2}}};
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+}
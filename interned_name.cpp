@@ -0,0 +1,52 @@
+//@	{"target":{"name":"interned_name.o"}}
+
+#include "./interned_name.hpp"
+
+#include <mutex>
+
+template<class Name>
+anon::interned_name anon::atom_table::intern(Name const& name, uint32_t hash)
+{
+	if(std::size(name) == 0)
+	{ return interned_name{}; }
+
+	auto& shard = m_shards[hash % std::size(m_shards)];
+	{
+		std::shared_lock lock{shard.mutex};
+		if(auto i = shard.names.find(name); i != std::end(shard.names))
+		{ return interned_name{&*i}; }
+	}
+
+	std::lock_guard lock{shard.mutex};
+	if constexpr(std::is_same_v<Name, property_name>)
+	{ return interned_name{&*shard.names.insert(name).first}; }
+	else
+	{ return interned_name{&*shard.names.insert(property_name{name}).first}; }
+}
+
+anon::interned_name anon::atom_table::intern(std::string_view name)
+{
+	return intern(name, property_name_hash(name));
+}
+
+anon::interned_name anon::atom_table::intern(property_name const& name)
+{
+	return intern(name, name.hash());
+}
+
+size_t anon::atom_table::size() const
+{
+	size_t ret = 0;
+	for(auto const& item : m_shards)
+	{
+		std::shared_lock lock{item.mutex};
+		ret += std::size(item.names);
+	}
+	return ret;
+}
+
+anon::atom_table& anon::global_atom_table()
+{
+	static atom_table table;
+	return table;
+}
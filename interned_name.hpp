@@ -0,0 +1,172 @@
+//@	{"dependencies_extra":[{"ref":"./interned_name.o","rel":"implementation"}]}
+
+#ifndef ANON_INTERNEDNAME_HPP
+#define ANON_INTERNEDNAME_HPP
+
+/**
+ * \file interned_name.hpp
+ *
+ * \brief Contains the definition of interned_name, and the table that holds interned names
+ */
+
+#include "./property_name.hpp"
+
+#include <array>
+#include <shared_mutex>
+#include <unordered_set>
+
+namespace anon
+{
+	/**
+	 * \brief A pointer-sized handle to a property name stored in the global atom_table
+	 *
+	 * Two interned_name objects refer to the same entry if and only if they hold the same name. Thus,
+	 * equality is checked by comparing pointers. Ordering is the same as for property_name.
+	 *
+	 * \ingroup property_names
+	 */
+	class interned_name
+	{
+	public:
+		/**
+		 * \brief Creates a handle to the empty property name
+		 */
+		interned_name():m_name{&empty}
+		{}
+
+		/**
+		 * \brief Looks up, or adds, src in the global atom_table
+		 *
+		 * \note If src cannot be used as a property name, an exception is thrown
+		 */
+		explicit interned_name(std::string_view src);
+
+		/**
+		 * \brief Looks up, or adds, src in the global atom_table
+		 */
+		explicit interned_name(property_name const& src);
+
+		/**
+		 * \brief Returns the property name this handle refers to
+		 */
+		property_name const& get() const
+		{ return *m_name; }
+
+		/**
+		 * \brief Returns a pointer to a c string, containing the property name
+		 */
+		char const* c_str() const
+		{ return m_name->c_str(); }
+
+		/**
+		 * \brief Returns the number of characters in the property name
+		 */
+		size_t size() const
+		{ return std::size(*m_name); }
+
+		/**
+		 * \brief Returns the hash value of the property name
+		 */
+		uint32_t hash() const
+		{ return m_name->hash(); }
+
+		bool operator==(interned_name const& other) const
+		{ return m_name == other.m_name; }
+
+		std::strong_ordering operator<=>(interned_name const& other) const
+		{
+			return m_name == other.m_name? std::strong_ordering::equal : *m_name <=> *other.m_name;
+		}
+
+		/**
+		 * \brief Converts the property name into a std::string_view
+		 */
+		operator std::string_view() const
+		{ return std::string_view{*m_name}; }
+
+	private:
+		friend class atom_table;
+
+		explicit interned_name(property_name const* name):m_name{name}
+		{}
+
+		static constexpr property_name empty{};
+		property_name const* m_name;
+	};
+
+	/**
+	 * \brief A table of property names that have been interned
+	 *
+	 * The table is split into shards based on the hash of the name, and each shard is protected by
+	 * a reader-writer lock. Looking up a name that already has been interned only requires a shared
+	 * lock, so threads that load documents with the same keys in parallel do not block each other.
+	 * Entries are never removed.
+	 *
+	 * \ingroup property_names
+	 */
+	class atom_table
+	{
+	public:
+		/**
+		 * \brief Returns a handle to name, and adds name to the table if needed
+		 */
+		interned_name intern(std::string_view name);
+
+		/**
+		 * \brief Returns a handle to name, and adds name to the table if needed
+		 */
+		interned_name intern(property_name const& name);
+
+		/**
+		 * \brief Returns the number of interned names
+		 */
+		size_t size() const;
+
+	private:
+		struct name_hash
+		{
+			using is_transparent = void;
+
+			size_t operator()(property_name const& name) const
+			{ return name.hash(); }
+
+			size_t operator()(std::string_view name) const
+			{ return property_name_hash(name); }
+		};
+
+		struct shard
+		{
+			mutable std::shared_mutex mutex;
+			std::unordered_set<property_name, name_hash, std::equal_to<>> names;
+		};
+
+		std::array<shard, 64> m_shards;
+
+		template<class Name>
+		interned_name intern(Name const& name, uint32_t hash);
+	};
+
+	/**
+	 * \brief Returns the table used by interned_name
+	 *
+	 * \ingroup property_names
+	 */
+	atom_table& global_atom_table();
+
+	inline interned_name::interned_name(std::string_view src):
+		interned_name{global_atom_table().intern(src)}
+	{}
+
+	inline interned_name::interned_name(property_name const& src):
+		interned_name{global_atom_table().intern(src)}
+	{}
+}
+
+template<>
+struct std::hash<anon::interned_name>
+{
+	size_t operator()(anon::interned_name const& name) const
+	{ return name.hash(); }
+};
+
+#endif
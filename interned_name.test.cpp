@@ -0,0 +1,86 @@
+//@	{"target":{"name":"interned_name.test"}}
+
+#include "./interned_name.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <thread>
+#include <vector>
+
+TESTCASE(anon_interned_name_create)
+{
+	anon::interned_name a{"foobar"};
+	anon::interned_name b{std::string{"foobar"}};
+	anon::interned_name c{anon::property_name{"foobar"}};
+
+	EXPECT_EQ(&a.get(), &b.get());
+	EXPECT_EQ(&a.get(), &c.get());
+	EXPECT_EQ(a, b);
+	EXPECT_EQ(std::string_view{a}, "foobar");
+	EXPECT_EQ(std::string_view{a.c_str()}, "foobar");
+	EXPECT_EQ(std::size(a), 6);
+	EXPECT_EQ(a.hash(), anon::property_name_hash("foobar"));
+	EXPECT_EQ(std::hash<anon::interned_name>{}(a), a.hash());
+
+	anon::interned_name d{"foobaz"};
+	EXPECT_NE(a, d);
+}
+
+TESTCASE(anon_interned_name_empty)
+{
+	anon::interned_name a;
+	anon::interned_name b{""};
+	EXPECT_EQ(a, b);
+	EXPECT_EQ(std::size(a), 0);
+	EXPECT_EQ(std::string_view{a.c_str()}, "");
+}
+
+TESTCASE(anon_interned_name_malformed)
+{
+	try
+	{
+		anon::interned_name name{"Foo"};
+		testcaseFailed();
+	}
+	catch(...)
+	{}
+}
+
+TESTCASE(anon_interned_name_order)
+{
+	anon::interned_name const b{"bar"};
+	anon::interned_name const a{"foo"};
+	anon::interned_name const c{"barbaz"};
+
+	EXPECT_LT(b, a);
+	EXPECT_LT(b, c);
+	EXPECT_LT(c, a);
+	EXPECT_EQ(a <=> anon::interned_name{"foo"}, std::strong_ordering::equal);
+}
+
+TESTCASE(anon_interned_name_from_many_threads)
+{
+	std::vector<std::string> names;
+	for(size_t k = 0; k != 256; ++k)
+	{ names.push_back(std::string{"threaded_name_"}.append(std::to_string(k))); }
+
+	std::array<std::vector<anon::interned_name>, 4> results;
+	std::vector<std::thread> threads;
+	for(auto& item : results)
+	{
+		threads.push_back(std::thread{[&names, &item]() {
+			for(auto const& name : names)
+			{ item.push_back(anon::interned_name{name}); }
+		}});
+	}
+
+	for(auto& item : threads)
+	{ item.join(); }
+
+	for(size_t k = 0; k != std::size(names); ++k)
+	{
+		EXPECT_EQ(std::string_view{results[0][k]}, names[k]);
+		for(auto const& item : results)
+		{ EXPECT_EQ(&item[k].get(), &results[0][k].get()); }
+	}
+}
@@ -0,0 +1,86 @@
+//@	{"target":{"name":"mmap_source.o"}}
+
+#include "./mmap_source.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+	// Owns a file descriptor, that is closed when the owner goes out of scope
+	class file_descriptor
+	{
+	public:
+		explicit file_descriptor(int fd):m_fd{fd}
+		{}
+
+		file_descriptor(file_descriptor const&) = delete;
+		file_descriptor& operator=(file_descriptor const&) = delete;
+
+		~file_descriptor()
+		{
+			if(m_fd != -1)
+			{ ::close(m_fd); }
+		}
+
+		int get() const
+		{ return m_fd; }
+
+	private:
+		int m_fd;
+	};
+}
+
+anon::mmap_source::mmap_source(std::filesystem::path const& path):
+	m_data{nullptr},
+	m_size{0},
+	m_read_offset{0}
+{
+	file_descriptor const fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+	if(fd.get() == -1)
+	{
+		throw std::runtime_error{std::string{"Failed to open file "}.append(path)};
+	}
+
+	struct stat st{};
+	if(::fstat(fd.get(), &st) == -1 || !S_ISREG(st.st_mode))
+	{
+		throw std::runtime_error{std::string{"Failed to map file "}.append(path)};
+	}
+
+	// mmap refuses zero-sized mappings, so an empty file is represented by an empty span
+	if(st.st_size == 0)
+	{ return; }
+
+	// Huge files are fine on 64-bit targets, but a file larger than the address space must be
+	// rejected rather than silently truncated
+	if(static_cast<uintmax_t>(st.st_size) > std::numeric_limits<size_t>::max())
+	{
+		throw std::runtime_error{std::string{"File too large to map "}.append(path)};
+	}
+
+	auto const size = static_cast<size_t>(st.st_size);
+	auto const ptr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+	if(ptr == MAP_FAILED)
+	{
+		throw std::runtime_error{std::string{"Failed to map file "}.append(path)};
+	}
+
+	::madvise(ptr, size, MADV_SEQUENTIAL);
+	m_data = static_cast<char const*>(ptr);
+	m_size = size;
+}
+
+anon::mmap_source::~mmap_source()
+{
+	if(m_data != nullptr)
+	{
+		::munmap(const_cast<char*>(m_data), m_size);
+	}
+}
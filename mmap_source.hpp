@@ -0,0 +1,101 @@
+//@	{"dependencies_extra":[{"ref":"./mmap_source.o","rel":"implementation"}]}
+
+#ifndef ANON_MMAPSOURCE_HPP
+#define ANON_MMAPSOURCE_HPP
+
+/**
+ * \file mmap_source.hpp
+ *
+ * \brief Contains the definition of mmap_source
+ */
+
+#include "./source.hpp"
+
+#include <filesystem>
+#include <span>
+#include <utility>
+
+namespace anon
+{
+	/**
+	 * \brief A source that maps an entire file into memory
+	 *
+	 * This class maps the file into memory, and presents it as a single contiguous chunk. This
+	 * avoids both the per-byte overhead of the C file API, and copying the file contents into a
+	 * separate buffer. The mapping is created read-only, and the kernel is advised that it will be
+	 * accessed sequentially.
+	 *
+	 * \note Only regular files can be mapped. For other kinds of files, the constructor throws an
+	 * exception.
+	 *
+	 * \ingroup de-serialization
+	 */
+	class mmap_source
+	{
+	public:
+		/**
+		 * \brief Maps the file referred to by path
+		 */
+		explicit mmap_source(std::filesystem::path const& path);
+
+		mmap_source(mmap_source&& other) noexcept:
+			m_data{std::exchange(other.m_data, nullptr)},
+			m_size{std::exchange(other.m_size, 0)},
+			m_read_offset{std::exchange(other.m_read_offset, 0)}
+		{}
+
+		mmap_source& operator=(mmap_source&& other) noexcept
+		{
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+			std::swap(m_read_offset, other.m_read_offset);
+			return *this;
+		}
+
+		~mmap_source();
+
+		/**
+		 * \brief Returns the entire contents of the file
+		 */
+		std::span<char const> data() const
+		{ return std::span{m_data, m_size}; }
+
+		/**
+		 * \brief Returns the part of the file that has not yet been consumed by read_chunk
+		 */
+		std::span<char const> remaining() const
+		{ return data().subspan(m_read_offset); }
+
+		/**
+		 * \brief Marks everything as consumed, and returns the part of the file that was not
+		 * consumed before
+		 */
+		std::span<char const> consume()
+		{
+			auto const ret = remaining();
+			m_read_offset = m_size;
+			return ret;
+		}
+
+	private:
+		char const* m_data;
+		size_t m_size;
+		size_t m_read_offset;
+	};
+
+	/**
+	 * \brief Returns all data in src that has not been read yet
+	 *
+	 * \ingroup de-serialization
+	 */
+	inline chunk_read_result read_chunk(mmap_source& src)
+	{
+		auto const ret = src.consume();
+		return chunk_read_result{
+			ret,
+			std::size(ret) == 0? stream_status::eof : stream_status::ready
+		};
+	}
+}
+
+#endif
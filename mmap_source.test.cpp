@@ -0,0 +1,74 @@
+//@	{"target":{"name":"mmap_source.test"}}
+
+#include "./mmap_source.hpp"
+
+#include "./deserializer.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <cstdio>
+#include <unistd.h>
+
+namespace
+{
+	std::filesystem::path write_temp_file(std::string_view content)
+	{
+		auto const path = std::filesystem::temp_directory_path()
+			/ (std::string{"anon_mmap_source_test_"} + std::to_string(getpid()));
+		auto const f = fopen(path.c_str(), "wb");
+		fwrite(std::data(content), 1, std::size(content), f);
+		fclose(f);
+		return path;
+	}
+}
+
+TESTCASE(anon_mmap_source_read_chunk)
+{
+	auto const path = write_temp_file("Hello, World");
+	anon::mmap_source src{path};
+	remove(path.c_str());
+
+	EXPECT_EQ(std::size(src.data()), 12);
+
+	auto const res_1 = read_chunk(src);
+	EXPECT_EQ(res_1.status, anon::stream_status::ready);
+	EXPECT_EQ((std::string_view{std::data(res_1.data), std::size(res_1.data)}), "Hello, World");
+
+	auto const res_2 = read_chunk(src);
+	EXPECT_EQ(res_2.status, anon::stream_status::eof);
+}
+
+TESTCASE(anon_mmap_source_empty_file)
+{
+	auto const path = write_temp_file("");
+	anon::mmap_source src{path};
+	remove(path.c_str());
+
+	EXPECT_EQ(std::size(src.data()), 0);
+	EXPECT_EQ(read_chunk(src).status, anon::stream_status::eof);
+}
+
+TESTCASE(anon_mmap_source_not_a_file)
+{
+	try
+	{
+		anon::mmap_source src{std::filesystem::temp_directory_path()};
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+}
+
+TESTCASE(anon_mmap_source_load_path)
+{
+	auto const path = write_temp_file(R"(obj{
+	a_string: str{this is a test with \\ and { } \}
+	an_array_of_i32: i32*{1\;2\;3\;\}
+\})");
+
+	auto obj = anon::load(path);
+	remove(path.c_str());
+
+	EXPECT_EQ(std::get<std::string>(obj["a_string"]), R"(this is a test with \ and { } )");
+	EXPECT_EQ(std::size(std::get<std::vector<int32_t>>(obj["an_array_of_i32"])), 3);
+}
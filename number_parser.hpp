@@ -0,0 +1,261 @@
+#ifndef ANON_NUMBERPARSER_HPP
+#define ANON_NUMBERPARSER_HPP
+
+/**
+ * \file number_parser.hpp
+ *
+ * \brief Contains functions for converting text to numbers
+ */
+
+#include "./type_info.hpp"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace anon
+{
+	namespace number_parser_detail
+	{
+		constexpr bool is_digit(char val)
+		{ return val >= '0' && val <= '9'; }
+
+		inline uint64_t load_eight_bytes(char const* ptr)
+		{
+			uint64_t ret;
+			std::memcpy(&ret, ptr, sizeof(ret));
+			if constexpr(std::endian::native == std::endian::big)
+			{ ret = __builtin_bswap64(ret); }
+			return ret;
+		}
+
+		/**
+		 * \brief Checks whether or not all bytes in val are decimal digits
+		 */
+		constexpr bool is_eight_digits(uint64_t val)
+		{
+			return ((val & 0xf0f0'f0f0'f0f0'f0f0) | (((val + 0x0606'0606'0606'0606) & 0xf0f0'f0f0'f0f0'f0f0) >> 4))
+				== 0x3333'3333'3333'3333;
+		}
+
+		/**
+		 * \brief Converts eight decimal digits, with the first digit in the least significant byte, to
+		 * a number
+		 */
+		constexpr uint32_t parse_eight_digits(uint64_t val)
+		{
+			constexpr uint64_t mask = 0x0000'00ff'0000'00ff;
+			constexpr uint64_t mul_1 = 100 + (1000000ull << 32);
+			constexpr uint64_t mul_2 = 1 + (10000ull << 32);
+			val -= 0x3030'3030'3030'3030;
+			val = (val * 10) + (val >> 8);
+			return static_cast<uint32_t>(((val & mask) * mul_1 + ((val >> 16) & mask) * mul_2) >> 32);
+		}
+
+		/**
+		 * \brief Accumulates the decimal digits starting at ptr into value
+		 *
+		 * \return A pointer to the first character that is not a digit. If the number of digits
+		 * exceeds 19, value may have wrapped around, which the caller must check by using
+		 * digit_count.
+		 */
+		inline char const* parse_digits(char const* ptr, char const* end, uint64_t& value,
+			size_t& digit_count)
+		{
+			while(end - ptr >= 8)
+			{
+				auto const block = load_eight_bytes(ptr);
+				if(!is_eight_digits(block))
+				{ break; }
+				value = value*100'000'000 + parse_eight_digits(block);
+				digit_count += 8;
+				ptr += 8;
+			}
+
+			while(ptr != end && is_digit(*ptr))
+			{
+				value = value*10 + static_cast<uint64_t>(*ptr - '0');
+				++digit_count;
+				++ptr;
+			}
+			return ptr;
+		}
+
+		/**
+		 * \brief Converts src to an integer, if src only contains an optional `-`, followed by at most
+		 * 19 digits, and the value fits in a T
+		 */
+		template<std::integral T>
+		std::optional<T> parse_integer(std::string_view src)
+		{
+			auto ptr = std::data(src);
+			auto const end = ptr + std::size(src);
+			auto const negative = std::is_signed_v<T> && ptr != end && *ptr == '-';
+			if(negative)
+			{ ++ptr; }
+
+			uint64_t value = 0;
+			size_t digit_count = 0;
+			ptr = parse_digits(ptr, end, value, digit_count);
+			if(ptr != end || digit_count == 0 || digit_count > 19)
+			{ return std::nullopt; }
+
+			using unsigned_type = std::make_unsigned_t<T>;
+			auto const max = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (negative? 1 : 0);
+			if(value > max)
+			{ return std::nullopt; }
+
+			return negative? static_cast<T>(unsigned_type{0} - static_cast<unsigned_type>(value))
+				: static_cast<T>(value);
+		}
+
+		template<std::floating_point T>
+		struct float_limits;
+
+		template<>
+		struct float_limits<float>
+		{
+			static constexpr uint64_t max_mantissa = uint64_t{1} << 24;
+			static constexpr int max_exponent = 10;
+		};
+
+		template<>
+		struct float_limits<double>
+		{
+			static constexpr uint64_t max_mantissa = uint64_t{1} << 53;
+			static constexpr int max_exponent = 22;
+		};
+
+		template<std::floating_point T>
+		constexpr T pow10(int exponent)
+		{
+			T ret = 1;
+			for(int k = 0; k != exponent; ++k)
+			{ ret *= 10; }
+			return ret;
+		}
+
+		template<std::floating_point T>
+		constexpr auto powers_of_ten = []<int ... Exponents>(std::integer_sequence<int, Exponents...>) {
+			return std::array<T, sizeof...(Exponents)>{pow10<T>(Exponents)...};
+		}(std::make_integer_sequence<int, float_limits<T>::max_exponent + 1>{});
+
+		/**
+		 * \brief Converts src to a floating point number, if the result can be computed exactly
+		 *
+		 * This is the fast path described by Clinger: If the digits fit in the mantissa of T, and the
+		 * power of ten can be represented exactly by T, a single correctly rounded multiplication or
+		 * division gives the correctly rounded result. Other input, including all malformed input, is
+		 * rejected.
+		 */
+		template<std::floating_point T>
+		std::optional<T> parse_float(std::string_view src)
+		{
+			auto ptr = std::data(src);
+			auto const end = ptr + std::size(src);
+			auto const negative = ptr != end && *ptr == '-';
+			if(negative)
+			{ ++ptr; }
+
+			uint64_t mantissa = 0;
+			size_t digit_count = 0;
+			ptr = parse_digits(ptr, end, mantissa, digit_count);
+			int exponent = 0;
+			if(ptr != end && *ptr == '.')
+			{
+				++ptr;
+				auto const integer_digits = digit_count;
+				ptr = parse_digits(ptr, end, mantissa, digit_count);
+				exponent = -static_cast<int>(digit_count - integer_digits);
+			}
+
+			if(digit_count == 0 || digit_count > 19)
+			{ return std::nullopt; }
+
+			if(ptr != end && (*ptr == 'e' || *ptr == 'E'))
+			{
+				++ptr;
+				auto const negative_exponent = ptr != end && *ptr == '-';
+				if(ptr != end && (*ptr == '-' || *ptr == '+'))
+				{ ++ptr; }
+
+				uint64_t exp_value = 0;
+				size_t exp_digits = 0;
+				ptr = parse_digits(ptr, end, exp_value, exp_digits);
+				if(exp_digits == 0 || exp_digits > 4)
+				{ return std::nullopt; }
+				exponent += negative_exponent? -static_cast<int>(exp_value) : static_cast<int>(exp_value);
+			}
+
+			if(ptr != end || mantissa > float_limits<T>::max_mantissa
+				|| exponent < -float_limits<T>::max_exponent || exponent > float_limits<T>::max_exponent)
+			{ return std::nullopt; }
+
+			auto value = static_cast<T>(mantissa);
+			value = exponent < 0 ? value / powers_of_ten<T>[-exponent] : value * powers_of_ten<T>[exponent];
+			return negative? -value : value;
+		}
+	}
+
+	/**
+	 * \brief Converts src to a T
+	 *
+	 * Common number formats are converted by a fast path. Anything else is converted by
+	 * `std::from_chars`, which gives the same result.
+	 *
+	 * \note If src does not contain a valid T, or contains anything after the number, an exception
+	 * is thrown
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class T>
+	requires(std::is_floating_point_v<T> || std::is_integral_v<T>)
+	T parse_number(std::string_view src)
+	{
+		if constexpr(std::is_integral_v<T>)
+		{
+			if(auto const res = number_parser_detail::parse_integer<T>(src); res.has_value())
+			{ return *res; }
+		}
+		else
+		{
+			if(auto const res = number_parser_detail::parse_float<T>(src); res.has_value())
+			{ return *res; }
+		}
+
+		T value{};
+		auto const begin = std::data(src);
+		auto const end = begin + std::size(src);
+		auto res = std::from_chars(begin, end, value);
+		if(res.ec == std::errc{})
+		{
+			if(res.ptr != end)
+			{
+				throw std::runtime_error{"Junk after number"};
+			}
+			return value;
+		}
+
+		switch(res.ec)
+		{
+			case std::errc::invalid_argument:
+				throw std::runtime_error{std::string{src}.append(" is not convertible to a number")};
+			case std::errc::result_out_of_range:
+				throw std::runtime_error{std::string{src}
+					.append(" does not fit in a ").append(type_info<T>::name())};
+			default:
+				__builtin_unreachable();
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,152 @@
+//@	{"target":{"name":"number_parser.test"}}
+
+#include "./number_parser.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	template<class T>
+	std::optional<T> parse_reference(std::string_view src)
+	{
+		T value{};
+		auto const res = std::from_chars(std::data(src), std::data(src) + std::size(src), value);
+		if(res.ec != std::errc{} || res.ptr != std::data(src) + std::size(src))
+		{ return std::nullopt; }
+		return value;
+	}
+
+	template<class T>
+	bool same_result(std::string_view src)
+	{
+		auto const expected = parse_reference<T>(src);
+		try
+		{
+			auto const value = anon::parse_number<T>(src);
+			if(!expected.has_value())
+			{ return false; }
+
+			if(std::isnan(*expected))
+			{ return std::isnan(value); }
+
+			return value == *expected && std::signbit(value) == std::signbit(*expected);
+		}
+		catch(std::runtime_error const&)
+		{ return !expected.has_value(); }
+	}
+
+	template<class T>
+	std::string error_message(std::string_view src)
+	{
+		try
+		{
+			anon::parse_number<T>(src);
+		}
+		catch(std::runtime_error const& err)
+		{ return err.what(); }
+		return "";
+	}
+}
+
+TESTCASE(anon_number_parser_digits)
+{
+	static_assert(anon::number_parser_detail::is_eight_digits(0x3938'3736'3534'3332));
+	static_assert(!anon::number_parser_detail::is_eight_digits(0x3938'3736'2e34'3332));
+	static_assert(!anon::number_parser_detail::is_eight_digits(0x3938'3736'3a34'3332));
+	static_assert(!anon::number_parser_detail::is_eight_digits(0x3938'3736'2f34'3332));
+	static_assert(anon::number_parser_detail::parse_eight_digits(0x3938'3736'3534'3332) == 23456789);
+}
+
+TESTCASE(anon_number_parser_integers)
+{
+	EXPECT_EQ(anon::parse_number<int32_t>("0"), 0);
+	EXPECT_EQ(anon::parse_number<int32_t>("-0"), 0);
+	EXPECT_EQ(anon::parse_number<int32_t>("123456789"), 123456789);
+	EXPECT_EQ(anon::parse_number<int32_t>("000000000000000000000000012"), 12);
+	EXPECT_EQ(anon::parse_number<int32_t>("2147483647"), std::numeric_limits<int32_t>::max());
+	EXPECT_EQ(anon::parse_number<int32_t>("-2147483648"), std::numeric_limits<int32_t>::min());
+	EXPECT_EQ(anon::parse_number<uint32_t>("4294967295"), std::numeric_limits<uint32_t>::max());
+	EXPECT_EQ(anon::parse_number<int64_t>("-9223372036854775808"), std::numeric_limits<int64_t>::min());
+	EXPECT_EQ(anon::parse_number<int64_t>("9223372036854775807"), std::numeric_limits<int64_t>::max());
+	EXPECT_EQ(anon::parse_number<uint64_t>("18446744073709551615"), std::numeric_limits<uint64_t>::max());
+
+	std::mt19937_64 rng;
+	for(size_t k = 0; k != 100000; ++k)
+	{
+		auto const val = rng() >> (rng() % 64);
+		auto const str = std::to_string(val);
+		EXPECT_EQ(anon::parse_number<uint64_t>(str), val);
+		auto const signed_val = -static_cast<int64_t>(val >> 1);
+		EXPECT_EQ(anon::parse_number<int64_t>(std::to_string(signed_val)), signed_val);
+	}
+}
+
+TESTCASE(anon_number_parser_integer_errors)
+{
+	EXPECT_EQ(error_message<int32_t>("2147483648"), "2147483648 does not fit in a i32");
+	EXPECT_EQ(error_message<int32_t>("-2147483649"), "-2147483649 does not fit in a i32");
+	EXPECT_EQ(error_message<uint32_t>("4294967296"), "4294967296 does not fit in a u32");
+	EXPECT_EQ(error_message<uint64_t>("18446744073709551616"), "18446744073709551616 does not fit in a u64");
+	EXPECT_EQ(error_message<int64_t>("123456789012345678901234"),
+		"123456789012345678901234 does not fit in a i64");
+	EXPECT_EQ(error_message<uint32_t>("-1"), "-1 is not convertible to a number");
+	EXPECT_EQ(error_message<int32_t>(""), " is not convertible to a number");
+	EXPECT_EQ(error_message<int32_t>("-"), "- is not convertible to a number");
+	EXPECT_EQ(error_message<int32_t>("+1"), "+1 is not convertible to a number");
+	EXPECT_EQ(error_message<int32_t>(" 1"), " 1 is not convertible to a number");
+	EXPECT_EQ(error_message<int32_t>("12345678x"), "Junk after number");
+	EXPECT_EQ(error_message<int32_t>("1.5"), "Junk after number");
+}
+
+TESTCASE(anon_number_parser_floats)
+{
+	for(auto const str : {"0", "-0", "1", "1.", ".5", "0.1", "-1.25", "3.14159265358979", "1e10",
+		"1E-10", "1.5e+3", "123456789012345678", "9007199254740993", "1e22", "1e23", "1e-22",
+		"4.9e-324", "1.7976931348623157e308", "inf", "-nan", "0.000000000000000000000000001",
+		"2.2250738585072014e-308", "7.038531e-26"})
+	{
+		EXPECT_EQ(same_result<double>(str), true);
+		EXPECT_EQ(same_result<float>(str), true);
+	}
+
+	std::mt19937_64 rng;
+	std::array<char, 64> buffer{};
+	for(size_t k = 0; k != 100000; ++k)
+	{
+		auto const val = std::bit_cast<double>(rng());
+		if(!std::isfinite(val))
+		{ continue; }
+
+		for(auto format : {std::chars_format::scientific, std::chars_format::fixed})
+		{
+			auto const res = std::to_chars(std::begin(buffer), std::end(buffer), val, format);
+			if(res.ec != std::errc{})
+			{ continue; }
+			std::string_view const str{std::data(buffer), res.ptr};
+			EXPECT_EQ(anon::parse_number<double>(str), val);
+			EXPECT_EQ(same_result<float>(str), true);
+		}
+
+		auto const short_val = static_cast<double>(rng() % 100000000)/1000.0;
+		auto const res = std::to_chars(std::begin(buffer), std::end(buffer), short_val,
+			std::chars_format::scientific);
+		std::string_view const str{std::data(buffer), res.ptr};
+		EXPECT_EQ(anon::parse_number<double>(str), short_val);
+		EXPECT_EQ(same_result<float>(str), true);
+	}
+}
+
+TESTCASE(anon_number_parser_float_errors)
+{
+	EXPECT_EQ(error_message<double>("1e"), "Junk after number");
+	EXPECT_EQ(error_message<double>("1.5x"), "Junk after number");
+	EXPECT_EQ(error_message<double>("."), ". is not convertible to a number");
+	EXPECT_EQ(error_message<double>("-"), "- is not convertible to a number");
+	EXPECT_EQ(error_message<double>("+1"), "+1 is not convertible to a number");
+	EXPECT_EQ(error_message<double>("1e400"), "1e400 does not fit in a f64");
+	EXPECT_EQ(error_message<float>("1e40"), "1e40 does not fit in a f32");
+}
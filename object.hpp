@@ -8,14 +8,20 @@
  */
 
 #include "./property_name.hpp"
+#include "./interned_name.hpp"
+#include "./flat_map.hpp"
+#include "./cow_map.hpp"
+#include "./cow_sequence.hpp"
+#include "./content_hash.hpp"
 
 #include <variant>
 #include <string>
 #include <map>
 #include <vector>
+#include <memory_resource>
 #include <cstdint>
 #include <stdexcept>
-#include <cstdint>
+#include <compare>
 
 /**
  * \defgroup objects Objects
@@ -24,7 +30,16 @@
  * mapped to a uniquely defined property value. The values are sorted by the corresponding property
  * name, as if `LC_COLLATE=C`. The storage type of property values is an instantiation of
  * var_with_arrays, and thus, multiple types are supported. The supported types are defined by
- * \ref object::mapped_type.
+ * \ref basic_object::mapped_type.
+ *
+ * How the properties are stored is determined by a storage policy. By default, an object stores
+ * its properties in a flat_map, which is compact and fast to search. For objects that are
+ * modified frequently, map_object, which uses a `std::map`, may be a better choice. When many
+ * objects share the same property names, interned_object saves memory by storing property names
+ * as interned_name handles. A pmr_object allocates its properties, strings, and arrays from a
+ * `std::pmr::memory_resource`, so an entire object tree can be placed in a single arena. A
+ * persistent_object shares its properties between copies, so that many versions of a large object
+ * can be kept at a low cost.
  *
  */
 namespace anon
@@ -46,19 +61,128 @@ namespace anon
 	template<class ... Args>
 	using var_with_arrays = std::variant<Args..., std::vector<Args>...>;
 
+	/**
+	 * \brief Same as var_with_arrays, but uses Array as array type
+	 *
+	 * \ingroup objects
+	 *
+	 */
+	template<template<class> class Array, class ... Args>
+	using basic_var_with_arrays = std::variant<Args..., Array<Args>...>;
+
+	/**
+	 * \brief Storage policy that stores properties in a flat_map
+	 *
+	 * \ingroup objects
+	 */
+	struct flat_storage
+	{
+		using key_type = property_name;
+		using string_type = std::string;
+
+		template<class T>
+		using array = std::vector<T>;
+
+		template<class Key, class Value>
+		using container = flat_map<Key, Value, std::less<>>;
+	};
+
+	/**
+	 * \brief Storage policy that stores properties in a `std::map`
+	 *
+	 * \ingroup objects
+	 */
+	struct map_storage
+	{
+		using key_type = property_name;
+		using string_type = std::string;
+
+		template<class T>
+		using array = std::vector<T>;
+
+		template<class Key, class Value>
+		using container = std::map<Key, Value, std::less<>>;
+	};
+
+	/**
+	 * \brief Storage policy that stores properties in a flat_map, using interned_name as key
+	 *
+	 * \ingroup objects
+	 */
+	struct interned_storage
+	{
+		using key_type = interned_name;
+		using string_type = std::string;
+
+		template<class T>
+		using array = std::vector<T>;
+
+		template<class Key, class Value>
+		using container = flat_map<Key, Value, std::less<>>;
+	};
+
+	/**
+	 * \brief Storage policy that stores properties in a flat_map, and allocates all memory through a
+	 * `std::pmr::polymorphic_allocator`
+	 *
+	 * \note Since `std::variant` is not allocator-aware, a copy of an array or string property
+	 * allocates its memory from the default memory resource. Moving a property keeps its memory
+	 * resource.
+	 *
+	 * \ingroup objects
+	 */
+	struct pmr_storage
+	{
+		using key_type = property_name;
+		using string_type = std::pmr::string;
+
+		template<class T>
+		using array = std::pmr::vector<T>;
+
+		template<class Key, class Value>
+		using container = flat_map<Key, Value, std::less<>,
+			std::pmr::polymorphic_allocator<std::pair<Key, Value>>>;
+	};
+
+	/**
+	 * \brief Storage policy that stores properties in a cow_map, and strings and arrays in a
+	 * cow_sequence
+	 *
+	 * Copying an object with this storage policy is O(1). When a copy is modified, only the property
+	 * tables of the objects on the path to the modified property are copied. All other objects, and
+	 * all strings and arrays, remain shared.
+	 *
+	 * \note Lookup and iteration give const access, also for a non-const object. A property value
+	 * can be modified through operator[], assign, or insert_or_assign.
+	 *
+	 * \ingroup objects
+	 */
+	struct cow_storage
+	{
+		using key_type = property_name;
+		using string_type = cow_string;
+
+		template<class T>
+		using array = cow_vector<T>;
+
+		template<class Key, class Value>
+		using container = cow_map<Key, Value, std::less<>>;
+	};
+
 	/**
 	 * \brief Representation of \ref objects
 	 *
-	 * This class represents an object. It is designed on top of a suitable instantiation of
-	 * `std::map`, and provides a similar interface. The main difference is that `operator[]` of an
-	 * object is "safe", and does not allow insertion of new properties. Instead, it behaves like
-	 * `std::map::at`, with the difference that a different exception is thrown when the key is not
-	 * found.
+	 * This class represents an object. It is designed on top of the associative container selected
+	 * by Storage, and provides an interface similar to `std::map`. The main difference is that
+	 * `operator[]` of an object is "safe", and does not allow insertion of new properties. Instead,
+	 * it behaves like `std::map::at`, with the difference that a different exception is thrown when
+	 * the key is not found.
 	 *
 	 * \ingroup objects
 	 *
 	 */
-	class object
+	template<class Storage>
+	class basic_object
 	{
 	public:
 		/**
@@ -66,21 +190,76 @@ namespace anon
 		 *
 		 * This type is used to represent property values. A property can be of any of the types
 		 * listed in this alias, and also the corresponding array type, as generated by
-		 * \ref var_with_arrays.
+		 * \ref basic_var_with_arrays. The string type and the array type are selected by Storage.
 		 *
 		 */
-		using mapped_type = var_with_arrays<int32_t, int64_t, uint32_t, uint64_t, float, double,
-			std::string, object>;
+		using mapped_type = basic_var_with_arrays<Storage::template array, int32_t, int64_t,
+			uint32_t, uint64_t, float, double, typename Storage::string_type, basic_object>;
+
+		/**
+		 * \brief The type used for string properties
+		 */
+		using string_type = typename Storage::string_type;
+
+		/**
+		 * \brief The type used for array properties
+		 */
+		template<class T>
+		using array_type = typename Storage::template array<T>;
 
 		/**
 		 * \brief The key type used for element lookup
 		 */
-		using key_type = property_name;
+		using key_type = typename Storage::key_type;
+
+		/**
+		 * \brief The type used to store properties
+		 */
+		using container_type = typename Storage::template container<key_type, mapped_type>;
 
 		/**
 		 * \brief The container element type
 		 */
-		using value_type = std::pair<key_type const, mapped_type>;
+		using value_type = typename container_type::value_type;
+
+		/**
+		 * \brief The allocator used for properties
+		 */
+		using allocator_type = typename container_type::allocator_type;
+
+		basic_object() = default;
+
+		/**
+		 * \brief Constructs an empty object, that allocates its properties using alloc
+		 */
+		explicit basic_object(allocator_type const& alloc):m_content{alloc}
+		{}
+
+		/**
+		 * \brief Copies other, but allocates the properties using alloc
+		 */
+		explicit basic_object(basic_object const& other, allocator_type const& alloc):
+			m_content{other.m_content, alloc},
+			m_hash{other.m_hash}
+		{}
+
+		/**
+		 * \brief Moves other, but allocates the properties using alloc
+		 */
+		explicit basic_object(basic_object&& other, allocator_type const& alloc):
+			m_content{std::move(other.m_content), alloc},
+			m_hash{std::move(other.m_hash)}
+		{}
+
+		/**
+		 * \brief Constructs an object from properties that are already sorted by name
+		 *
+		 * \note If properties are not sorted, or contains duplicated names, an exception is thrown
+		 */
+		explicit basic_object(sorted_unique_t, std::vector<value_type>&& properties)
+		requires(std::is_constructible_v<container_type, sorted_unique_t, std::vector<value_type>&&>):
+			m_content{sorted_unique, std::move(properties)}
+		{}
 
 		/**
 		 * \name insert_or_assign
@@ -92,27 +271,29 @@ namespace anon
 		 */
 		///@{
 		template<class T>
-		object& insert_or_assign(key_type&& key, T&& val) &
+		basic_object& insert_or_assign(key_type&& key, T&& val) &
 		{
+			m_hash.reset();
 			m_content.insert_or_assign(std::move(key), std::forward<T>(val));
 			return *this;
 		}
 
 		template<class T>
-		object&& insert_or_assign(key_type&& key, T&& val) &&
+		basic_object&& insert_or_assign(key_type&& key, T&& val) &&
 		{
+			m_hash.reset();
 			m_content.insert_or_assign(std::move(key), std::forward<T>(val));
 			return std::move(*this);
 		}
 
 		template<class T>
-		object& insert_or_assign(std::string_view key, T&& val) &
+		basic_object& insert_or_assign(std::string_view key, T&& val) &
 		{
 			return insert_or_assign(key_type{key}, std::forward<T>(val));
 		}
 
 		template<class T>
-		object&& insert_or_assign(std::string_view key, T&& val) &&
+		basic_object&& insert_or_assign(std::string_view key, T&& val) &&
 		{
 			return std::move(insert_or_assign(key_type{key}, std::forward<T>(val)));
 		}
@@ -130,22 +311,24 @@ namespace anon
 		 */
 		///@{
 		template<class T>
-		object& assign(std::string_view key, T&& val) &
+		basic_object& assign(std::string_view key, T&& val) &
 		{
-			if(auto i = m_content.find(key); i!= std::end(m_content))
+			m_hash.reset();
+			if(auto const value = find_for_write(key); value != nullptr)
 			{
-				i->second = std::forward<T>(val);
+				*value = std::forward<T>(val);
 				return *this;
 			}
 			throw std::runtime_error{"Key not found"};
 		}
 
 		template<class T>
-		object&& assign(std::string_view key, T&& val) &&
+		basic_object&& assign(std::string_view key, T&& val) &&
 		{
-			if(auto i = m_content.find(key); i!= std::end(m_content))
+			m_hash.reset();
+			if(auto const value = find_for_write(key); value != nullptr)
 			{
-				i->second = std::forward<T>(val);
+				*value = std::forward<T>(val);
 				return std::move(*this);
 			}
 			throw std::runtime_error{"Key not found"};
@@ -164,8 +347,9 @@ namespace anon
 		 */
 		///@{
 		template<class T>
-		object& insert(key_type&& key, T&& val) &
+		basic_object& insert(key_type&& key, T&& val) &
 		{
+			m_hash.reset();
 			if(auto ip = m_content.insert(std::pair{std::move(key), std::forward<T>(val)}); ip.second)
 			{
 				return *this;
@@ -174,9 +358,10 @@ namespace anon
 		}
 
 		template<class T>
-		object&& insert(key_type&& key, T&& val) &&
+		basic_object&& insert(key_type&& key, T&& val) &&
 		{
-			if(auto ip = m_content.insert(std::move(key), std::forward<T>(val)); ip.second)
+			m_hash.reset();
+			if(auto ip = m_content.insert(std::pair{std::move(key), std::forward<T>(val)}); ip.second)
 			{
 				return std::move(*this);
 			}
@@ -205,6 +390,16 @@ namespace anon
 		}
 
 		auto& operator[](std::string_view key)
+		{
+			m_hash.disable();
+			if(auto const value = find_for_write(key); value != nullptr)
+			{
+				return *value;
+			}
+			throw std::runtime_error{"Key not found"};
+		}
+
+		auto const& operator[](key_type const& key) const
 		{
 			if(auto i = m_content.find(key); i != std::end(m_content))
 			{
@@ -212,19 +407,38 @@ namespace anon
 			}
 			throw std::runtime_error{"Key not found"};
 		}
+
+		auto& operator[](key_type const& key)
+		{
+			m_hash.disable();
+			if(auto const value = find_for_write(key); value != nullptr)
+			{
+				return *value;
+			}
+			throw std::runtime_error{"Key not found"};
+		}
 		///@}
 
 		/**
+		 * \name contains
+		 *
 		 * \brief Checks whether or not the object has an property with name key
 		 *
 		 * \return true if and only if the property exists, otherwise false
 		 *
 		 */
+		///@{
 		bool contains(std::string_view key) const
 		{
 			return m_content.contains(key);
 		}
 
+		bool contains(key_type const& key) const
+		{
+			return m_content.contains(key);
+		}
+		///@}
+
 		/**
 		 * \name find
 		 *
@@ -238,11 +452,45 @@ namespace anon
 		}
 
 		decltype(auto) find(std::string_view key)
+		{
+			return expose(m_content.find(key));
+		}
+
+		decltype(auto) find(key_type const& key) const
 		{
 			return m_content.find(key);
 		}
+
+		decltype(auto) find(key_type const& key)
+		{
+			return expose(m_content.find(key));
+		}
 		///@}
 
+		/**
+		 * \brief Returns the allocator used for properties
+		 */
+		allocator_type get_allocator() const
+		{
+			return m_content.get_allocator();
+		}
+
+		/**
+		 * \brief Removes the property with name key
+		 *
+		 * \return true if the property existed, otherwise false
+		 */
+		bool erase(std::string_view key)
+		{
+			m_hash.reset();
+			if(auto i = m_content.find(key); i != std::end(m_content))
+			{
+				m_content.erase(i);
+				return true;
+			}
+			return false;
+		}
+
 		/**
 		 * \brief Returns the number of properties this object has
 		 */
@@ -251,6 +499,18 @@ namespace anon
 			return std::size(m_content);
 		}
 
+		/**
+		 * \brief Removes all properties from this object
+		 *
+		 * \note For storage policies that use a flat_map, the capacity is kept, so the object can
+		 * be refilled without allocating a new property array
+		 */
+		void clear()
+		{
+			m_hash.reset();
+			m_content.clear();
+		}
+
 		/**
 		 * \name Iterator access
 		 *
@@ -263,7 +523,7 @@ namespace anon
 
 		decltype(auto) begin()
 		{
-			return std::begin(m_content);
+			return expose(std::begin(m_content));
 		}
 
 		decltype(auto) end() const
@@ -273,15 +533,122 @@ namespace anon
 
 		decltype(auto) end()
 		{
-			return std::end(m_content);
+			return expose(std::end(m_content));
 		}
 		///@}
 
-		auto operator<=>(object const&) const = default;
+		/**
+		 * \brief Computes the content hash of this object
+		 *
+		 * The hash is computed from the names of the properties, and the hashes of their values.
+		 * Objects with the same properties have the same hash, regardless of their storage policy.
+		 *
+		 * The hash is cached until the object is modified through insert, insert_or_assign, assign,
+		 * erase, or clear, so an unmodified object is not visited again. Once a member function has
+		 * returned a reference, or iterator, through which a property can be modified, the object
+		 * can no longer tell when its content changes. From then on, the hash of this object is
+		 * recomputed on every call, while nested objects still use their own cache. Use
+		 * `std::as_const` to look up properties without losing the cache. A copy of the object
+		 * starts with a cache of its own.
+		 *
+		 * \see \ref anon::content_hash
+		 */
+		uint64_t content_hash() const
+		{
+			if(auto const cached = m_hash.get(); cached != 0)
+			{ return cached; }
+
+			auto ret = hash_detail::mix(std::size(m_content));
+			for(auto const& item : m_content)
+			{
+				ret = hash_detail::combine(ret, anon::content_hash(item.first));
+				ret = hash_detail::combine(ret, anon::content_hash(item.second));
+			}
+
+			// Zero is used to indicate that no hash has been computed
+			ret = ret != 0? ret : 1;
+			m_hash.set(ret);
+			return ret;
+		}
+
+		/**
+		 * \brief Compares the properties of this object with the properties of other
+		 *
+		 * If the content hash of both objects is cached, and they differ, the properties are not
+		 * visited.
+		 */
+		bool operator==(basic_object const& other) const
+		{
+			if(auto const a = m_hash.get(), b = other.m_hash.get(); a != 0 && b != 0 && a != b)
+			{ return false; }
+			return m_content == other.m_content;
+		}
+
+		std::partial_ordering operator<=>(basic_object const& other) const
+		{ return m_content <=> other.m_content; }
 
 	private:
-		std::map<key_type, mapped_type, std::less<>> m_content;
+		container_type m_content;
+		hash_detail::hash_cache m_hash;
+
+		// Disables the hash cache if i can be used to modify a property
+		template<class Iterator>
+		Iterator expose(Iterator i)
+		{
+			if constexpr(!std::is_const_v<std::remove_reference_t<decltype((i->second))>>)
+			{ m_hash.disable(); }
+			return i;
+		}
+
+		// Returns a pointer to the value of the property with name key, that can be used to modify
+		// it, or nullptr if there is no such property
+		template<class K>
+		mapped_type* find_for_write(K const& key)
+		{
+			if constexpr(requires{ m_content.find_for_write(key); })
+			{ return m_content.find_for_write(key); }
+			else
+			{
+				auto const i = m_content.find(key);
+				return i != std::end(m_content)? &i->second : nullptr;
+			}
+		}
 	};
+
+	/**
+	 * \brief The default object type, that stores its properties in a flat_map
+	 *
+	 * \ingroup objects
+	 */
+	using object = basic_object<flat_storage>;
+
+	/**
+	 * \brief An object type that stores its properties in a `std::map`
+	 *
+	 * \ingroup objects
+	 */
+	using map_object = basic_object<map_storage>;
+
+	/**
+	 * \brief An object type that stores its properties in a flat_map, using interned_name as key
+	 *
+	 * \ingroup objects
+	 */
+	using interned_object = basic_object<interned_storage>;
+
+	/**
+	 * \brief An object type that allocates all its memory from a `std::pmr::memory_resource`
+	 *
+	 * \ingroup objects
+	 */
+	using pmr_object = basic_object<pmr_storage>;
+
+	/**
+	 * \brief An object type whose copies share their properties, until they are modified
+	 *
+	 * \ingroup objects
+	 */
+	using persistent_object = basic_object<cow_storage>;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,245 @@
+//@	{"target":{"name":"object_view.o"}}
+
+#include "./object_view.hpp"
+#include "./type_info.hpp"
+#include "./scanner.hpp"
+
+#include <algorithm>
+
+namespace
+{
+	constexpr bool is_whitespace(char val)
+	{
+		return val >= '\0' && val<= ' ';
+	}
+
+	char const* skip_whitespace(char const* ptr, char const* end)
+	{
+		while(ptr != end && is_whitespace(*ptr))
+		{ ++ptr; }
+		return ptr;
+	}
+
+	bool is_ctrl_sequence(char const* ptr, char const* end)
+	{
+		return end - ptr >= 2 && *ptr == '\\' && (ptr[1] == ';' || ptr[1] == '}');
+	}
+
+	size_t type_index(std::string_view name)
+	{
+		using variant_type = anon::object::mapped_type;
+		auto const index
+			= anon::variant_helper::find_type<variant_type>([name]<class T>(anon::variant_helper::empty<T>){
+			return name == anon::type_info<T>::name();
+		});
+
+		if(index == std::variant_npos)
+		{
+			throw std::runtime_error{std::string{"Unsupported type '"}.append(name).append("'")};
+		}
+		return index;
+	}
+
+	constexpr auto object_index
+		= anon::variant_helper::index_of<anon::object, anon::object::mapped_type>;
+
+	constexpr auto object_array_index
+		= anon::variant_helper::index_of<std::vector<anon::object>, anon::object::mapped_type>;
+
+	// Reads a type tag and the following `{`, and leaves ptr directly after the `{`
+	size_t read_type_tag(char const*& ptr, char const* end)
+	{
+		ptr = skip_whitespace(ptr, end);
+		auto const begin = ptr;
+		while(ptr != end && *ptr != '{' && !is_whitespace(*ptr))
+		{ ++ptr; }
+		std::string_view const name{begin, ptr};
+
+		ptr = skip_whitespace(ptr, end);
+		if(ptr == end)
+		{ throw std::runtime_error{"Empty or incomplete value"}; }
+
+		if(*ptr != '{')
+		{ throw std::runtime_error{"Junk after type tag"}; }
+
+		++ptr;
+		return type_index(name);
+	}
+
+	// Finds the end of the value body starting at ptr. On return, ptr points to the `\` of the
+	// `\}` that terminates the value.
+	void skip_value_body(size_t type, char const*& ptr, char const* end)
+	{
+		switch(type)
+		{
+			case object_index:
+				anon::view_detail::scan_object_body(ptr, end, nullptr);
+				if(is_ctrl_sequence(ptr, end) && ptr[1] == ';')
+				{ throw std::runtime_error{"Multiple values require an array"}; }
+				break;
+
+			case object_array_index:
+				while(true)
+				{
+					auto const n = anon::view_detail::scan_object_body(ptr, end, nullptr);
+					if(!is_ctrl_sequence(ptr, end) || ptr[1] == '}')
+					{
+						if(n != 0)
+						{ throw std::runtime_error{"Non-terminated array element"}; }
+						break;
+					}
+					ptr += 2;
+				}
+				break;
+
+			default:
+				while(true)
+				{
+					ptr = anon::view_detail::find_ctrl_sequence(ptr, end);
+					if(ptr == end || ptr[1] == '}')
+					{ break; }
+					ptr += 2;
+				}
+		}
+
+		if(ptr == end)
+		{ throw std::runtime_error{"Empty or incomplete value"}; }
+	}
+
+	std::string unescape(std::string_view src)
+	{
+		std::string ret;
+		ret.reserve(std::size(src));
+		auto ptr = std::data(src);
+		auto const end = ptr + std::size(src);
+		while(ptr != end)
+		{
+			if(*ptr == '\\')
+			{
+				++ptr;
+				if(ptr == end)
+				{ break; }
+			}
+			ret += *ptr;
+			++ptr;
+		}
+		return ret;
+	}
+}
+
+anon::unescaped_string::unescaped_string(std::string_view src)
+{
+	if(src.find('\\') == std::string_view::npos)
+	{
+		m_view = src;
+		return;
+	}
+
+	m_storage = unescape(src);
+	m_owned = true;
+}
+
+char const* anon::view_detail::find_ctrl_sequence(char const* ptr, char const* end)
+{
+	while(true)
+	{
+		ptr = scanner::find_value_delimiter(ptr, end);
+		if(ptr == end)
+		{ return end; }
+
+		if(*ptr == '\0')
+		{ throw std::runtime_error{"Null character detected in input stream"}; }
+
+		if(end - ptr < 2)
+		{ throw std::runtime_error{"Empty or incomplete value"}; }
+
+		if(ptr[1] == ';' || ptr[1] == '}')
+		{ return ptr; }
+
+		if(ptr[1] == '\0')
+		{ throw std::runtime_error{"Null character detected in input stream"}; }
+
+		ptr += 2;
+	}
+}
+
+anon::unescaped_string anon::view_detail::single_value(std::string_view body)
+{
+	auto const begin = std::data(body);
+	auto const end = begin + std::size(body);
+	if(find_ctrl_sequence(begin, end) != end)
+	{ throw std::runtime_error{"Multiple values require an array"}; }
+
+	return unescaped_string{body};
+}
+
+anon::value_view anon::view_detail::read_value(char const*& ptr, char const* end)
+{
+	auto const type = read_type_tag(ptr, end);
+	auto const body_begin = ptr;
+	skip_value_body(type, ptr, end);
+	value_view ret{type, std::string_view{body_begin, ptr}};
+	ptr += 2;
+	return ret;
+}
+
+size_t anon::view_detail::scan_object_body(char const*& ptr, char const* end,
+	std::vector<std::pair<std::string_view, value_view>>* properties)
+{
+	size_t ret = 0;
+	while(true)
+	{
+		ptr = skip_whitespace(ptr, end);
+		if(ptr == end || is_ctrl_sequence(ptr, end))
+		{ return ret; }
+
+		auto const key_begin = ptr;
+		ptr = scanner::find_key_delimiter(ptr, end);
+		std::string_view const key{key_begin, ptr};
+
+		ptr = skip_whitespace(ptr, end);
+		if(ptr == end)
+		{ throw std::runtime_error{"Empty or incomplete value"}; }
+
+		if(*ptr != ':')
+		{
+			if(*ptr == '\\')
+			{
+				throw std::runtime_error{std::string{"Malformed property name '"}
+					.append(key).append("'")};
+			}
+			throw std::runtime_error{"Junk after key"};
+		}
+
+		if(!is_valid_property_name(key))
+		{
+			throw std::runtime_error{std::string{"Malformed property name '"}.append(key).append("'")};
+		}
+
+		++ptr;
+		auto const value = read_value(ptr, end);
+		if(properties != nullptr)
+		{ properties->push_back(std::pair{key, value}); }
+		++ret;
+	}
+}
+
+anon::object_view::object_view(std::string_view body)
+{
+	auto ptr = std::data(body);
+	auto const end = ptr + std::size(body);
+	view_detail::scan_object_body(ptr, end, &m_properties);
+	if(ptr != end)
+	{ throw std::runtime_error{"Multiple values require an array"}; }
+
+	auto const by_key = [](auto const& a, auto const& b) { return a.first < b.first; };
+
+	// Serialized objects are already sorted, so only sort if needed
+	if(!std::ranges::is_sorted(m_properties, by_key))
+	{ std::ranges::stable_sort(m_properties, by_key); }
+
+	if(std::ranges::adjacent_find(m_properties, [](auto const& a, auto const& b) {
+		return a.first == b.first;
+	}) != std::end(m_properties))
+	{ throw std::runtime_error{"Key already exists"}; }
+}
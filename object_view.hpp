@@ -0,0 +1,420 @@
+//@	{"dependencies_extra":[{"ref":"./object_view.o","rel":"implementation"}]}
+
+#ifndef ANON_OBJECTVIEW_HPP
+#define ANON_OBJECTVIEW_HPP
+
+/**
+ * \file object_view.hpp
+ *
+ * \brief Contains the definition of object_view and value_view, and their associated functions
+ */
+
+#include "./object.hpp"
+#include "./number_parser.hpp"
+#include "./variant_helper.hpp"
+
+#include <span>
+#include <string_view>
+#include <vector>
+#include <iterator>
+
+/**
+ * \defgroup views Views
+ *
+ * Views provide read-only access to anon data that is stored in a buffer, for example a file that
+ * has been mapped into memory by an mmap_source. Unlike an object, a view does not copy any data.
+ * An object_view only indexes its direct properties, and nested objects are indexed when they are
+ * accessed. Numbers are converted when they are accessed, and strings are only copied if they
+ * contain escaped characters.
+ *
+ * \note The buffer must outlive all views that refer to it
+ *
+ * \note Property names that contain escaped characters are not supported by views
+ *
+ */
+
+namespace anon
+{
+	class value_view;
+
+	/**
+	 * \brief A string value, that has been unescaped if needed
+	 *
+	 * \ingroup views
+	 */
+	class unescaped_string
+	{
+	public:
+		unescaped_string() = default;
+
+		/**
+		 * \brief Constructs an unescaped_string from src
+		 *
+		 * If src contains `\`, all escape sequences are resolved into an internal buffer.
+		 * Otherwise, the object refers directly to src.
+		 */
+		explicit unescaped_string(std::string_view src);
+
+		/**
+		 * \brief Returns the string value
+		 */
+		std::string_view view() const
+		{ return m_owned? std::string_view{m_storage} : m_view; }
+
+		operator std::string_view() const
+		{ return view(); }
+
+		/**
+		 * \brief Returns true if the string had to be copied
+		 */
+		bool owns_data() const
+		{ return m_owned; }
+
+		bool operator==(std::string_view other) const
+		{ return view() == other; }
+
+	private:
+		std::string_view m_view;
+		std::string m_storage;
+		bool m_owned{false};
+	};
+
+	/**
+	 * \brief Read-only view of an object
+	 *
+	 * An object_view indexes the direct properties of an object body. The index is sorted by
+	 * property name, as if `LC_COLLATE=C`, so it can be iterated in the same order as an object.
+	 *
+	 * \ingroup views
+	 */
+	class object_view;
+
+	/**
+	 * \brief Read-only view of an array
+	 *
+	 * Elements are located and converted while iterating. T is the type returned by
+	 * value_view::get for a single element, that is, a number type, unescaped_string, or
+	 * object_view.
+	 *
+	 * \ingroup views
+	 */
+	template<class T>
+	class array_view;
+
+	namespace view_detail
+	{
+		template<class T>
+		struct viewed_type
+		{ using type = T; };
+
+		template<>
+		struct viewed_type<unescaped_string>
+		{ using type = std::string; };
+
+		template<>
+		struct viewed_type<object_view>
+		{ using type = object; };
+
+		template<class T>
+		struct viewed_type<array_view<T>>
+		{ using type = std::vector<typename viewed_type<T>::type>; };
+
+		/**
+		 * \brief Parses the value starting at ptr, and leaves ptr directly after its final `\}`
+		 */
+		value_view read_value(char const*& ptr, char const* end);
+
+		/**
+		 * \brief Scans the properties of the object body starting at ptr
+		 *
+		 * This function scans the object body starting at ptr. It stops at end, or at a `\` that
+		 * starts a `\;` or `\}` that terminates the body. If properties is not null, the properties
+		 * are appended to it.
+		 *
+		 * \return The number of properties found
+		 */
+		size_t scan_object_body(char const*& ptr, char const* end,
+			std::vector<std::pair<std::string_view, value_view>>* properties);
+
+		/**
+		 * \brief Returns a pointer to the `\` that starts the next `\;` or `\}`, or end if there is no
+		 * such sequence
+		 */
+		char const* find_ctrl_sequence(char const* ptr, char const* end);
+
+		/**
+		 * \brief Returns the content of a non-array value body
+		 *
+		 * \note If body contains a `\;`, an exception is thrown
+		 */
+		unescaped_string single_value(std::string_view body);
+	}
+
+	/**
+	 * \brief Read-only view of a property value
+	 *
+	 * \ingroup views
+	 */
+	class value_view
+	{
+	public:
+		value_view() = default;
+
+		/**
+		 * \brief Creates a view of a value of the type with index type_index in object::mapped_type
+		 *
+		 * \param type_index The index of the value type in object::mapped_type
+		 * \param body Everything between the `{` and the `\}` that closes the value
+		 */
+		explicit value_view(size_t type_index, std::string_view body):
+			m_type_index{type_index},
+			m_body{body}
+		{}
+
+		/**
+		 * \brief Returns the index of the type this view refers to, in object::mapped_type
+		 */
+		size_t type_index() const
+		{ return m_type_index; }
+
+		/**
+		 * \brief Returns the raw value body
+		 */
+		std::string_view body() const
+		{ return m_body; }
+
+		/**
+		 * \brief Checks whether or not get<T> would succeed
+		 */
+		template<class T>
+		bool holds_alternative() const
+		{
+			return m_type_index
+				== variant_helper::index_of<typename view_detail::viewed_type<T>::type, object::mapped_type>;
+		}
+
+		/**
+		 * \brief Retrieves the value as a T
+		 *
+		 * T can be any number type supported by object, std::string, unescaped_string,
+		 * object_view, or an array_view of any of these except std::string.
+		 *
+		 * \note If this view does not refer to a T, std::bad_variant_access is thrown
+		 */
+		template<class T>
+		T get() const;
+
+		bool operator==(value_view const&) const = default;
+
+	private:
+		size_t m_type_index{std::variant_npos};
+		std::string_view m_body;
+	};
+
+	class object_view
+	{
+	public:
+		/**
+		 * \brief The type used to hold properties
+		 */
+		using value_type = std::pair<std::string_view, value_view>;
+
+		object_view() = default;
+
+		/**
+		 * \brief Indexes the object body body
+		 *
+		 * \note If body contains duplicated properties, an exception is thrown
+		 */
+		explicit object_view(std::string_view body);
+
+		/**
+		 * \brief Retrieves the value of an existing property
+		 *
+		 * \note If the property does not exist, an exception is thrown
+		 */
+		value_view operator[](std::string_view key) const
+		{
+			if(auto i = find(key); i != std::end(m_properties))
+			{ return i->second; }
+			throw std::runtime_error{"Key not found"};
+		}
+
+		/**
+		 * \brief Looks up a property with name key
+		 */
+		std::vector<value_type>::const_iterator find(std::string_view key) const
+		{
+			auto const i = std::ranges::lower_bound(m_properties, key, std::less<>{}, &value_type::first);
+			return i != std::end(m_properties) && i->first == key? i : std::end(m_properties);
+		}
+
+		/**
+		 * \brief Checks whether or not the object has an property with name key
+		 */
+		bool contains(std::string_view key) const
+		{ return find(key) != std::end(m_properties); }
+
+		/**
+		 * \brief Returns the number of properties
+		 */
+		size_t size() const
+		{ return std::size(m_properties); }
+
+		/**
+		 * \name Iterator access
+		 */
+		///@{
+		auto begin() const
+		{ return std::begin(m_properties); }
+
+		auto end() const
+		{ return std::end(m_properties); }
+		///@}
+
+	private:
+		std::vector<value_type> m_properties;
+	};
+
+	template<class T>
+	class array_view
+	{
+	public:
+		class iterator
+		{
+		public:
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() = default;
+
+			explicit iterator(char const* begin, char const* end):
+				m_begin{begin},
+				m_end{end},
+				m_element_end{begin}
+			{ next_element(); }
+
+			T operator*() const
+			{
+				std::string_view const element{m_begin, m_element_end};
+				if constexpr(std::is_same_v<T, object_view>)
+				{ return object_view{element}; }
+				else
+				if constexpr(std::is_same_v<T, unescaped_string>)
+				{ return unescaped_string{element}; }
+				else
+				{ return parse_number<T>(unescaped_string{element}); }
+			}
+
+			iterator& operator++()
+			{
+				m_begin = m_element_end + 2;
+				next_element();
+				return *this;
+			}
+
+			iterator operator++(int)
+			{
+				auto ret = *this;
+				++(*this);
+				return ret;
+			}
+
+			bool operator==(std::default_sentinel_t) const
+			{ return m_element_end == m_end; }
+
+			bool operator==(iterator const& other) const
+			{ return m_begin == other.m_begin; }
+
+		private:
+			char const* m_begin{nullptr};
+			char const* m_end{nullptr};
+			char const* m_element_end{nullptr};
+
+			void next_element()
+			{
+				if constexpr(std::is_same_v<T, object_view>)
+				{
+					auto ptr = m_begin;
+					auto const n = view_detail::scan_object_body(ptr, m_end, nullptr);
+					if(ptr == m_end && n != 0)
+					{ throw std::runtime_error{"Non-terminated array element"}; }
+					m_element_end = ptr;
+				}
+				else
+				{
+					m_element_end = view_detail::find_ctrl_sequence(m_begin, m_end);
+					if(m_element_end == m_end && m_begin != m_end)
+					{
+						throw std::runtime_error{std::string{"Non-terminated array element "}
+							.append(m_begin, m_end)};
+					}
+				}
+			}
+		};
+
+		array_view() = default;
+
+		/**
+		 * \brief Creates a view of the array body body
+		 */
+		explicit array_view(std::string_view body):m_body{body}
+		{}
+
+		auto begin() const
+		{ return iterator{std::data(m_body), std::data(m_body) + std::size(m_body)}; }
+
+		auto end() const
+		{ return std::default_sentinel; }
+
+		/**
+		 * \brief Counts the number of elements in the array
+		 *
+		 * \note This requires a scan through the entire array
+		 */
+		size_t size() const
+		{
+			size_t ret = 0;
+			for(auto i = begin(); i != end(); ++i)
+			{ ++ret; }
+			return ret;
+		}
+
+	private:
+		std::string_view m_body;
+	};
+
+	template<class T>
+	T value_view::get() const
+	{
+		if(!holds_alternative<T>())
+		{ throw std::bad_variant_access{}; }
+
+		if constexpr(std::is_same_v<T, object_view>)
+		{ return object_view{m_body}; }
+		else
+		if constexpr(std::is_same_v<T, unescaped_string>)
+		{ return view_detail::single_value(m_body); }
+		else
+		if constexpr(std::is_same_v<T, std::string>)
+		{ return std::string{view_detail::single_value(m_body).view()}; }
+		else
+		if constexpr(std::is_arithmetic_v<T>)
+		{ return parse_number<T>(view_detail::single_value(m_body)); }
+		else
+		{ return T{m_body}; }
+	}
+
+	/**
+	 * \brief Creates a view of the first value in src
+	 *
+	 * \ingroup views
+	 */
+	inline value_view load_view(std::span<char const> src)
+	{
+		auto ptr = std::data(src);
+		return view_detail::read_value(ptr, ptr + std::size(src));
+	}
+}
+
+#endif
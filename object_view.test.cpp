@@ -0,0 +1,158 @@
+//@	{"target":{"name":"object_view.test"}}
+
+#include "./object_view.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+namespace
+{
+	constexpr std::string_view test_data{R"(
+obj{
+	an_object: obj{
+		a_string: str{this is a test with ; \\ and { } \}
+		a_second_string: str{foobar\}
+		a_third_level: obj{
+			kaka:str{bulle\}
+		\}
+	\}
+	a_string: str{a string\}
+	an_array_of_strings: str*{First string\;Second string\;Third \\string\;\}
+	an_array_of_objects: obj*{
+		foobar:str*{A\;B\;C\;\}
+		kaka:str*{D\;E\;F\;\}\;
+
+		key_in_second_obj:str{Hello world\}\;
+	\}
+	an_i32: i32{1\}
+	an_array_of_i32: i32*{1\;2\;3\;\}
+	an_u64: u64{18446744073709551615\}
+	an_f64: f64{1.5\}
+	an_array_of_f64: f64*{1\;2\;3\;\}
+	an_empty_array_1: i32*{\}
+	an_empty_array_2: obj*{\}
+\}blah)"};
+}
+
+TESTCASE(anon_object_view_load)
+{
+	auto const obj = anon::load_view(test_data).get<anon::object_view>();
+	EXPECT_EQ(std::size(obj), 11);
+	EXPECT_EQ(std::is_sorted(std::begin(obj), std::end(obj), [](auto const& a, auto const& b) {
+		return a.first < b.first;
+	}), true);
+
+	{
+		auto const an_object = obj["an_object"].get<anon::object_view>();
+		EXPECT_EQ(std::size(an_object), 3);
+
+		auto const a_string = an_object["a_string"].get<anon::unescaped_string>();
+		EXPECT_EQ(a_string, R"(this is a test with ; \ and { } )");
+		EXPECT_EQ(a_string.owns_data(), true);
+
+		auto const a_second_string = an_object["a_second_string"].get<anon::unescaped_string>();
+		EXPECT_EQ(a_second_string, "foobar");
+		EXPECT_EQ(a_second_string.owns_data(), false);
+
+		auto const a_third_level = an_object["a_third_level"].get<anon::object_view>();
+		EXPECT_EQ(a_third_level["kaka"].get<std::string>(), "bulle");
+	}
+
+	{
+		std::vector<std::string> strings;
+		for(auto const& item : obj["an_array_of_strings"].get<anon::array_view<anon::unescaped_string>>())
+		{ strings.push_back(std::string{item.view()}); }
+
+		REQUIRE_EQ(std::size(strings), 3);
+		EXPECT_EQ(strings[0], "First string");
+		EXPECT_EQ(strings[1], "Second string");
+		EXPECT_EQ(strings[2], R"(Third \string)");
+	}
+
+	{
+		auto const an_array_of_objects
+			= obj["an_array_of_objects"].get<anon::array_view<anon::object_view>>();
+		EXPECT_EQ(std::size(an_array_of_objects), 2);
+		auto i = std::begin(an_array_of_objects);
+		EXPECT_EQ(std::size((*i)["kaka"].get<anon::array_view<anon::unescaped_string>>()), 3);
+		++i;
+		EXPECT_EQ((*i)["key_in_second_obj"].get<std::string>(), "Hello world");
+		++i;
+		EXPECT_EQ(i == std::end(an_array_of_objects), true);
+	}
+
+	EXPECT_EQ(obj["an_i32"].get<int32_t>(), 1);
+	EXPECT_EQ(obj["an_u64"].get<uint64_t>(), 18446744073709551615u);
+	EXPECT_EQ(obj["an_f64"].get<double>(), 1.5);
+
+	{
+		std::vector<int32_t> vals;
+		for(auto item : obj["an_array_of_i32"].get<anon::array_view<int32_t>>())
+		{ vals.push_back(item); }
+		EXPECT_EQ(vals, (std::vector<int32_t>{1, 2, 3}));
+	}
+
+	EXPECT_EQ(std::size(obj["an_empty_array_1"].get<anon::array_view<int32_t>>()), 0);
+	EXPECT_EQ(std::size(obj["an_empty_array_2"].get<anon::array_view<anon::object_view>>()), 0);
+}
+
+TESTCASE(anon_object_view_wrong_type)
+{
+	auto const obj = anon::load_view(test_data).get<anon::object_view>();
+	EXPECT_EQ(obj["an_i32"].holds_alternative<int32_t>(), true);
+	EXPECT_EQ(obj["an_i32"].holds_alternative<int64_t>(), false);
+
+	try
+	{
+		(void)obj["an_i32"].get<int64_t>();
+		testcaseFailed();
+	}
+	catch(std::bad_variant_access const&)
+	{}
+
+	try
+	{
+		(void)obj["does_not_exist"];
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+}
+
+TESTCASE(anon_object_view_unsorted_input)
+{
+	auto const obj = anon::load_view(std::string_view{R"(obj{b:i32{2\} a:i32{1\} c:i32{3\}\})"})
+		.get<anon::object_view>();
+	REQUIRE_EQ(std::size(obj), 3);
+	EXPECT_EQ(std::begin(obj)->first, "a");
+	EXPECT_EQ(obj["b"].get<int32_t>(), 2);
+}
+
+TESTCASE(anon_object_view_errors)
+{
+	for(std::string_view doc : {
+		R"(obj{a:i32{2\} a:i32{1\}\})",
+		R"(obj{a:i32{2\;3\}\})",
+		R"(obj{a:i32*{2\;3\}\})",
+		R"(obj{a:foo{2\}\})",
+		R"(obj{a:i32{2\})",
+		R"(obj{Abc:i32{2\}\})",
+		R"(obj{a b:i32{2\}\})",
+		R"(obj{a:i32 x{2\}\})"})
+	{
+		try
+		{
+			auto const obj = anon::load_view(doc).get<anon::object_view>();
+			for(auto const& item : obj)
+			{
+				if(item.second.holds_alternative<int32_t>())
+				{ (void)item.second.get<int32_t>(); }
+				else
+				if(item.second.holds_alternative<anon::array_view<int32_t>>())
+				{ (void)std::size(item.second.get<anon::array_view<int32_t>>()); }
+			}
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+}
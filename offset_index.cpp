@@ -0,0 +1,198 @@
+//@	{"target":{"name":"offset_index.o"}}
+
+#include "./offset_index.hpp"
+#include "./binary.hpp"
+#include "./scanner.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+	constexpr bool is_whitespace(char val)
+	{
+		return val >= '\0' && val <= ' ';
+	}
+
+	// Returns the key that precedes the value starting at value_begin
+	std::string_view property_key(char const* begin, char const* value_begin)
+	{
+		auto const key_end = std::find(begin, value_begin, ':');
+		if(key_end == value_begin)
+		{ throw std::runtime_error{"Expected a key"}; }
+
+		auto const key_begin = std::find_if_not(begin, key_end, is_whitespace);
+		return std::string_view{key_begin, std::find_if(key_begin, key_end, is_whitespace)};
+	}
+
+	void index_properties(anon::offset_index& index, char const* base, char const* ptr, char const* end)
+	{
+		size_t level = 1;
+		auto last = ptr;
+		auto value_begin = ptr;
+		std::string_view key;
+		while(true)
+		{
+			ptr = anon::scanner::find_structure_delimiter(ptr, end);
+			if(ptr == end)
+			{ throw std::runtime_error{"Empty or incomplete value"}; }
+
+			if(*ptr == '{')
+			{
+				auto const tag = anon::scanner::type_tag(last, ptr);
+				if(level == 1)
+				{
+					value_begin = std::data(tag);
+					key = property_key(last, value_begin);
+				}
+
+				if(tag == "obj" || tag == "obj*")
+				{
+					++level;
+					++ptr;
+				}
+				else
+				{
+					ptr = anon::scanner::skip_value(ptr + 1, end);
+					if(level == 1)
+					{
+						index.add(key, anon::offset_index::entry{static_cast<uint64_t>(value_begin - base),
+							static_cast<uint64_t>(ptr - value_begin)});
+					}
+				}
+				last = ptr;
+				continue;
+			}
+
+			if(end - ptr < 2)
+			{ throw std::runtime_error{"Empty or incomplete value"}; }
+
+			if(ptr[1] == '}')
+			{
+				--level;
+				if(level == 0)
+				{
+					if(!std::all_of(last, ptr, is_whitespace))
+					{ throw std::runtime_error{"Junk at end of object"}; }
+					return;
+				}
+
+				if(level == 1)
+				{
+					index.add(key, anon::offset_index::entry{static_cast<uint64_t>(value_begin - base),
+						static_cast<uint64_t>(ptr + 2 - value_begin)});
+				}
+			}
+			ptr += 2;
+			last = ptr;
+		}
+	}
+}
+
+anon::offset_index anon::build_offset_index(std::span<char const> input, int64_t source_mtime)
+{
+	auto const begin = std::data(input);
+	auto const end = begin + std::size(input);
+
+	auto const value_begin = std::find(begin, end, '{');
+	auto const tag = value_begin != end? scanner::type_tag(begin, value_begin) : std::string_view{};
+	if(tag == "obj*")
+	{
+		offset_index ret{offset_index::value_kind::object_array, std::size(input), source_mtime};
+		for(auto element : split_object_array(input))
+		{
+			ret.add(offset_index::entry{static_cast<uint64_t>(std::data(element) - begin),
+				std::size(element)});
+		}
+		return ret;
+	}
+
+	if(tag == "obj")
+	{
+		offset_index ret{offset_index::value_kind::object, std::size(input), source_mtime};
+		index_properties(ret, begin, value_begin + 1, end);
+		return ret;
+	}
+
+	throw std::runtime_error{"Expected an obj or an obj*"};
+}
+
+anon::offset_index anon::build_offset_index(std::filesystem::path const& path)
+{
+	// Get the modification time first, so a change made while the index is being built is detected
+	// later
+	auto const mtime = offset_index_detail::modification_time(path);
+	return build_offset_index(mmap_source{path}.data(), mtime);
+}
+
+void anon::save_offset_index(offset_index const& index, std::filesystem::path const& path)
+{
+	object obj;
+	obj.insert(property_name{"kind"}, std::string{index.kind() == offset_index::value_kind::object?
+		"obj" : "obj*"});
+	obj.insert(property_name{"source_size"}, index.source_size());
+	obj.insert(property_name{"source_mtime"}, index.source_mtime());
+	obj.insert(property_name{"keys"}, std::vector<std::string>(std::begin(index.keys()), std::end(index.keys())));
+	obj.insert(property_name{"offsets"},
+		std::vector<uint64_t>(std::begin(index.offsets()), std::end(index.offsets())));
+	obj.insert(property_name{"lengths"},
+		std::vector<uint64_t>(std::begin(index.lengths()), std::end(index.lengths())));
+	auto const data = to_binary(obj);
+
+	auto file_deleter = [](FILE* f){ return fclose(f); };
+	std::unique_ptr<FILE, decltype(file_deleter)> sink{fopen(path.c_str(), "wb")};
+	if(sink == nullptr || fwrite(std::data(data), 1, std::size(data), sink.get()) != std::size(data))
+	{
+		throw std::runtime_error{std::string{"Failed to write file "}.append(path)};
+	}
+}
+
+anon::offset_index anon::load_offset_index(std::filesystem::path const& path)
+{
+	auto const obj = load_binary(mmap_source{path});
+	auto const& kind = std::get<std::string>(obj["kind"]);
+	if(kind != "obj" && kind != "obj*")
+	{ throw std::runtime_error{"Unsupported index kind"}; }
+
+	auto const& keys = std::get<std::vector<std::string>>(obj["keys"]);
+	auto const& offsets = std::get<std::vector<uint64_t>>(obj["offsets"]);
+	auto const& lengths = std::get<std::vector<uint64_t>>(obj["lengths"]);
+	if(std::size(offsets) != std::size(lengths)
+		|| (kind == "obj" && std::size(keys) != std::size(offsets))
+		|| (kind == "obj*" && std::size(keys) != 0))
+	{ throw std::runtime_error{"Inconsistent index"}; }
+
+	offset_index ret{kind == "obj"? offset_index::value_kind::object : offset_index::value_kind::object_array,
+		std::get<uint64_t>(obj["source_size"]), std::get<int64_t>(obj["source_mtime"])};
+	for(size_t k = 0; k != std::size(offsets); ++k)
+	{
+		if(kind == "obj")
+		{ ret.add(keys[k], offset_index::entry{offsets[k], lengths[k]}); }
+		else
+		{ ret.add(offset_index::entry{offsets[k], lengths[k]}); }
+	}
+	return ret;
+}
+
+int64_t anon::offset_index_detail::modification_time(std::filesystem::path const& path)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		last_write_time(path).time_since_epoch()).count();
+}
+
+std::span<char const> anon::offset_index_detail::get_slice(std::filesystem::path const& path,
+	mmap_source const& src, offset_index const& index, offset_index::entry location)
+{
+	auto const data = src.data();
+	if(std::size(data) != index.source_size()
+		|| (index.source_mtime() != 0 && modification_time(path) != index.source_mtime()))
+	{ throw std::runtime_error{"Index does not match file"}; }
+
+	if(location.offset > std::size(data) || location.length > std::size(data) - location.offset)
+	{ throw std::runtime_error{"Index entry is out of range"}; }
+
+	return data.subspan(location.offset, location.length);
+}
@@ -0,0 +1,279 @@
+//@	{"dependencies_extra":[{"ref":"./offset_index.o","rel":"implementation"}]}
+
+#ifndef ANON_OFFSETINDEX_HPP
+#define ANON_OFFSETINDEX_HPP
+
+/**
+ * \file offset_index.hpp
+ *
+ * \brief Contains the definition of offset_index, which makes it possible to load parts of a large
+ * file without reading all of it
+ */
+
+#include "./deserializer.hpp"
+#include "./parallel_loader.hpp"
+#include "./mmap_source.hpp"
+#include "./property_name.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace anon
+{
+	/**
+	 * \brief Holds the byte offsets of the top-level values in a file
+	 *
+	 * If the outermost value is an `obj`, the index holds the location of each property value,
+	 * including its type tag. If the outermost value is an `obj*`, the index holds the location of the
+	 * body of each element.
+	 *
+	 * An index can be saved to a sidecar file with save_offset_index. The sidecar is stored in the
+	 * binary encoding, with the offsets and lengths as contiguous arrays.
+	 *
+	 * To detect that a file has changed since the index was built, the index records both the size
+	 * and the modification time of the file. The content itself is not checked, since that would
+	 * require reading the entire file.
+	 *
+	 * \ingroup de-serialization
+	 */
+	class offset_index
+	{
+	public:
+		/**
+		 * \brief The location of a value
+		 */
+		struct entry
+		{
+			uint64_t offset;
+			uint64_t length;
+		};
+
+		/**
+		 * \brief The type of the outermost value
+		 */
+		enum class value_kind{object, object_array};
+
+		offset_index() = default;
+
+		/**
+		 * \brief Creates an empty index for a file with size source_size and modification time
+		 * source_mtime
+		 *
+		 * The modification time is given in nanoseconds, and zero means that it is unknown.
+		 */
+		explicit offset_index(value_kind kind, uint64_t source_size, int64_t source_mtime = 0):
+			m_kind{kind},
+			m_source_size{source_size},
+			m_source_mtime{source_mtime}
+		{}
+
+		/**
+		 * \brief Adds the location of the value with key
+		 *
+		 * \note If key is not a valid property name, or has already been added, an exception is
+		 * thrown
+		 */
+		void add(std::string_view key, entry location)
+		{
+			std::string name{property_name{key}};
+			if(!m_positions.try_emplace(name, std::size(m_offsets)).second)
+			{ throw std::runtime_error{"Key already exists"}; }
+			m_keys.push_back(std::move(name));
+			add(location);
+		}
+
+		/**
+		 * \brief Adds the location of the next array element
+		 */
+		void add(entry location)
+		{
+			m_offsets.push_back(location.offset);
+			m_lengths.push_back(location.length);
+		}
+
+		/**
+		 * \brief Returns the location of the property with key, or std::nullopt if there is no
+		 * such property
+		 */
+		std::optional<entry> find(std::string_view key) const
+		{
+			auto const i = m_positions.find(key);
+			if(i == std::end(m_positions))
+			{ return std::nullopt; }
+			return (*this)[i->second];
+		}
+
+		/**
+		 * \brief Returns the location of the value at position
+		 */
+		entry operator[](size_t position) const
+		{ return entry{m_offsets[position], m_lengths[position]}; }
+
+		/**
+		 * \brief Returns the number of values in the index
+		 */
+		size_t size() const
+		{ return std::size(m_offsets); }
+
+		value_kind kind() const
+		{ return m_kind; }
+
+		/**
+		 * \brief Returns the size of the file that the index was built from
+		 */
+		uint64_t source_size() const
+		{ return m_source_size; }
+
+		/**
+		 * \brief Returns the modification time, in nanoseconds, of the file that the index was
+		 * built from, or zero if it is unknown
+		 */
+		int64_t source_mtime() const
+		{ return m_source_mtime; }
+
+		std::span<std::string const> keys() const
+		{ return m_keys; }
+
+		std::span<uint64_t const> offsets() const
+		{ return m_offsets; }
+
+		std::span<uint64_t const> lengths() const
+		{ return m_lengths; }
+
+	private:
+		value_kind m_kind{value_kind::object};
+		uint64_t m_source_size{0};
+		int64_t m_source_mtime{0};
+		std::vector<std::string> m_keys;
+		std::vector<uint64_t> m_offsets;
+		std::vector<uint64_t> m_lengths;
+
+		struct key_hash
+		{
+			using is_transparent = void;
+
+			size_t operator()(std::string_view key) const
+			{ return std::hash<std::string_view>{}(key); }
+		};
+
+		std::unordered_map<std::string, size_t, key_hash, std::equal_to<>> m_positions;
+	};
+
+	/**
+	 * \brief Builds an offset_index for input, which was read from a file with modification time
+	 * source_mtime
+	 *
+	 * Like split_object_array, this function only tracks the nesting level, and does not validate
+	 * the values themselves. However, duplicated keys are rejected.
+	 *
+	 * \ingroup de-serialization
+	 */
+	offset_index build_offset_index(std::span<char const> input, int64_t source_mtime = 0);
+
+	/**
+	 * \brief Builds an offset_index for the file referred to by path
+	 *
+	 * \ingroup de-serialization
+	 */
+	offset_index build_offset_index(std::filesystem::path const& path);
+
+	/**
+	 * \brief Saves index to a sidecar file
+	 *
+	 * \ingroup de-serialization
+	 */
+	void save_offset_index(offset_index const& index, std::filesystem::path const& path);
+
+	/**
+	 * \brief Loads an offset_index from a sidecar file created by save_offset_index
+	 *
+	 * \ingroup de-serialization
+	 */
+	offset_index load_offset_index(std::filesystem::path const& path);
+
+	namespace offset_index_detail
+	{
+		/**
+		 * \brief Returns the modification time of the file referred to by path, in nanoseconds
+		 */
+		int64_t modification_time(std::filesystem::path const& path);
+
+		/**
+		 * \brief Returns the part of src, which was mapped from path, that is referred to by
+		 * location
+		 *
+		 * \note If the file does not have the size and modification time recorded in index, an
+		 * exception is thrown
+		 */
+		std::span<char const> get_slice(std::filesystem::path const& path, mmap_source const& src,
+			offset_index const& index, offset_index::entry location);
+	}
+
+	/**
+	 * \brief Loads the value of the property key, from the file referred to by path
+	 *
+	 * Only the part of the file that holds the value is read and parsed.
+	 *
+	 * \note An exception is thrown if the size or the modification time of the file differs from
+	 * what is recorded in index, since this means that the file has changed since the index was
+	 * built.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class Object = object>
+	typename Object::mapped_type load_at(std::filesystem::path const& path, offset_index const& index,
+		std::string_view key)
+	{
+		if(index.kind() != offset_index::value_kind::object)
+		{ throw std::runtime_error{"Index does not refer to an obj"}; }
+
+		auto const location = index.find(key);
+		if(!location.has_value())
+		{ throw std::runtime_error{std::string{"Key "}.append(key).append(" not found in index")}; }
+
+		mmap_source src{path};
+		auto const slice = offset_index_detail::get_slice(path, src, index, *location);
+		auto ctxt = create_parser_context<Object>();
+		auto const res = update(slice, *ctxt);
+		if(res.status != parse_result::done || res.bytes_consumed != std::size(slice))
+		{ throw std::runtime_error{"Index does not match value"}; }
+		return take_result_and_reset(*ctxt);
+	}
+
+	/**
+	 * \brief Loads the element at position of the `obj*` in the file referred to by path
+	 *
+	 * Only the part of the file that holds the element is read and parsed.
+	 *
+	 * \note An exception is thrown if the size or the modification time of the file differs from
+	 * what is recorded in index, since this means that the file has changed since the index was
+	 * built.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class Object = object>
+	Object load_at(std::filesystem::path const& path, offset_index const& index, size_t position)
+	{
+		if(index.kind() != offset_index::value_kind::object_array)
+		{ throw std::runtime_error{"Index does not refer to an obj*"}; }
+
+		if(position >= std::size(index))
+		{ throw std::runtime_error{"Position is out of range"}; }
+
+		mmap_source src{path};
+		auto const slice = offset_index_detail::get_slice(path, src, index, index[position]);
+		std::vector<Object> ret;
+		parallel_loader_detail::load_elements<Object>(std::span{&slice, 1}, ret);
+		return std::move(ret.front());
+	}
+}
+
+#endif
@@ -0,0 +1,199 @@
+//@	{"target":{"name":"offset_index.test"}}
+
+#include "./offset_index.hpp"
+#include "./binary.hpp"
+#include "./serializer.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <unistd.h>
+
+namespace
+{
+	std::filesystem::path write_temp_file(std::string_view name, std::string_view content)
+	{
+		auto const path = std::filesystem::temp_directory_path()
+			/ (std::string{"anon_offset_index_test_"}.append(name).append("_") + std::to_string(getpid()));
+		auto const f = fopen(path.c_str(), "wb");
+		fwrite(std::data(content), 1, std::size(content), f);
+		fclose(f);
+		return path;
+	}
+
+	std::string_view slice(std::string_view src, anon::offset_index::entry location)
+	{ return src.substr(location.offset, location.length); }
+
+	constexpr std::string_view test_object{R"(obj{
+	name: str{Test\}
+	blob  :str{Contains obj{ and \\\}
+	settings: obj{
+		colors: obj*{fg: str{obj*{\}\;bg: obj {value:str{black\}\}\;\}
+	\}
+	values:f64*{1\;2\;3\;\}
+	title: str{Test 2\}
+\})"};
+
+	constexpr std::string_view test_array{R"(obj*{
+	a: i32{1\}\;
+	b: obj{c: str{{\}\}\;
+	\;
+\})"};
+}
+
+TESTCASE(anon_offset_index_object)
+{
+	auto const index = anon::build_offset_index(std::span{std::data(test_object), std::size(test_object)});
+	EXPECT_EQ(index.kind(), anon::offset_index::value_kind::object);
+	EXPECT_EQ(index.source_size(), std::size(test_object));
+	REQUIRE_EQ(std::size(index), 5);
+	EXPECT_EQ(index.keys()[1], "blob");
+	EXPECT_EQ(slice(test_object, index[1]), R"(str{Contains obj{ and \\\})");
+	EXPECT_EQ(slice(test_object, *index.find("settings")),
+		R"(obj{
+		colors: obj*{fg: str{obj*{\}\;bg: obj {value:str{black\}\}\;\}
+	\})");
+	EXPECT_EQ(slice(test_object, *index.find("values")), R"(f64*{1\;2\;3\;\})");
+	EXPECT_EQ(slice(test_object, *index.find("name")), R"(str{Test\})");
+	EXPECT_EQ(slice(test_object, *index.find("title")), R"(str{Test 2\})");
+	EXPECT_EQ(index.find("missing").has_value(), false);
+}
+
+TESTCASE(anon_offset_index_array)
+{
+	auto const index = anon::build_offset_index(std::span{std::data(test_array), std::size(test_array)});
+	EXPECT_EQ(index.kind(), anon::offset_index::value_kind::object_array);
+	REQUIRE_EQ(std::size(index), 3);
+	EXPECT_EQ(slice(test_array, index[0]), "\n\ta: i32{1\\}");
+	EXPECT_EQ(slice(test_array, index[1]), "\n\tb: obj{c: str{{\\}\\}");
+	EXPECT_EQ(slice(test_array, index[2]), "\n\t");
+}
+
+TESTCASE(anon_offset_index_load_at)
+{
+	auto const data_path = write_temp_file("data", test_object);
+	auto const index_path = write_temp_file("index", "");
+	anon::save_offset_index(anon::build_offset_index(data_path), index_path);
+	auto const index = anon::load_offset_index(index_path);
+	remove(index_path.c_str());
+
+	REQUIRE_EQ(std::size(index), 5);
+	EXPECT_EQ(std::get<std::string>(anon::load_at(data_path, index, "title")), "Test 2");
+	EXPECT_EQ(index.source_mtime(), anon::build_offset_index(data_path).source_mtime());
+	EXPECT_EQ(std::size(std::get<std::vector<double>>(anon::load_at(data_path, index, "values"))), 3);
+	auto const settings = std::get<anon::object>(anon::load_at(data_path, index, "settings"));
+	EXPECT_EQ(std::size(std::get<std::vector<anon::object>>(settings["colors"])), 2);
+
+	try
+	{
+		(void)anon::load_at(data_path, index, "missing");
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+
+	try
+	{
+		(void)anon::load_at(data_path, index, 0);
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+
+	// A modified file must be detected, even if its size is unchanged
+	auto const mtime = std::filesystem::last_write_time(data_path);
+	{
+		auto const f = fopen(data_path.c_str(), "r+b");
+		fputs("obj{\n\tname: str{Tost\\}", f);
+		fclose(f);
+	}
+	std::filesystem::last_write_time(data_path, mtime + std::chrono::seconds{1});
+	try
+	{
+		(void)anon::load_at(data_path, index, "name");
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+
+	auto const f = fopen(data_path.c_str(), "ab");
+	fputs("\n", f);
+	fclose(f);
+	try
+	{
+		(void)anon::load_at(data_path, index, "name");
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+	remove(data_path.c_str());
+}
+
+TESTCASE(anon_offset_index_load_at_element)
+{
+	auto const data_path = write_temp_file("data", test_array);
+	auto const index = anon::build_offset_index(data_path);
+
+	EXPECT_EQ(std::get<int32_t>(anon::load_at(data_path, index, 0)["a"]), 1);
+	EXPECT_EQ(std::get<std::string>(
+		std::get<anon::object>(anon::load_at(data_path, index, 1)["b"])["c"]), "{");
+	EXPECT_EQ(std::size(anon::load_at(data_path, index, 2)), 0);
+
+	try
+	{
+		(void)anon::load_at(data_path, index, 3);
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+	remove(data_path.c_str());
+}
+
+TESTCASE(anon_offset_index_errors)
+{
+	for(auto const src : {R"(str{Hello\})", R"(obj{a: str{x\})", R"(obj{str{x\}\})",
+		R"(obj{a: i32{1\} junk\})", R"(obj{a: i32{1\} a: i32{2\}\})", R"(obj{Name: i32{1\}\})",
+		R"(obj{a_name_that_is_far_too_long_to_be_valid: i32{1\}\})", ""})
+	{
+		try
+		{
+			std::string_view const str{src};
+			(void)anon::build_offset_index(std::span{std::data(str), std::size(str)});
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+}
+
+TESTCASE(anon_offset_index_malformed_key)
+{
+	anon::offset_index index{anon::offset_index::value_kind::object, 0};
+	try
+	{
+		index.add("Not a property name", anon::offset_index::entry{0, 0});
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+	EXPECT_EQ(std::size(index), 0);
+
+	// A key read from the sidecar file is validated as well
+	anon::object obj;
+	obj.insert(anon::property_name{"kind"}, std::string{"obj"})
+		.insert(anon::property_name{"source_size"}, uint64_t{0})
+		.insert(anon::property_name{"source_mtime"}, int64_t{0})
+		.insert(anon::property_name{"keys"}, std::vector<std::string>{"__reserved"})
+		.insert(anon::property_name{"offsets"}, std::vector<uint64_t>{0})
+		.insert(anon::property_name{"lengths"}, std::vector<uint64_t>{0});
+	auto const index_path = write_temp_file("malformed_index", anon::to_binary(obj));
+	try
+	{
+		(void)anon::load_offset_index(index_path);
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+	remove(index_path.c_str());
+}
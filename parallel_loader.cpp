@@ -0,0 +1,100 @@
+//@	{"target":{"name":"parallel_loader.o"}}
+
+#include "./parallel_loader.hpp"
+#include "./scanner.hpp"
+#include "./type_info.hpp"
+#include "./variant_helper.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	constexpr bool is_whitespace(char val)
+	{
+		return val >= '\0' && val <= ' ';
+	}
+
+	// Returns a pointer past the opening brace of the outermost value, after checking that its type
+	// tag is obj*. Errors are reported with the same messages as the event_parser uses.
+	char const* skip_array_type_tag(char const* ptr, char const* end)
+	{
+		auto const tag_begin = std::find_if_not(ptr, end, is_whitespace);
+		auto const tag_end = std::find_if(tag_begin, end, [](char val) {
+			return val == '{' || is_whitespace(val);
+		});
+		auto const value_begin = std::find_if_not(tag_end, end, is_whitespace);
+		if(value_begin == end)
+		{ throw std::runtime_error{"Empty or incomplete value"}; }
+
+		if(*value_begin != '{')
+		{ throw std::runtime_error{"Junk after type tag"}; }
+
+		std::string_view const tag{tag_begin, tag_end};
+		if(tag == anon::type_info<std::vector<anon::object>>::name())
+		{ return value_begin + 1; }
+
+		auto const index = anon::variant_helper::find_type<anon::object::mapped_type>(
+			[tag]<class T>(anon::variant_helper::empty<T>){
+				return tag == anon::type_info<T>::name();
+			});
+		if(index == std::variant_npos)
+		{ throw std::runtime_error{std::string{"Unsupported type '"}.append(tag).append("'")}; }
+
+		throw std::runtime_error{"Expected an obj*"};
+	}
+}
+
+std::vector<std::span<char const>> anon::split_object_array(std::span<char const> input)
+{
+	auto const end = std::data(input) + std::size(input);
+	auto ptr = skip_array_type_tag(std::data(input), end);
+	std::vector<std::span<char const>> ret;
+	auto element_begin = ptr;
+	size_t level = 1;
+	while(true)
+	{
+		ptr = anon::scanner::find_structure_delimiter(ptr, end);
+		if(ptr == end)
+		{ throw std::runtime_error{"Empty or incomplete value"}; }
+
+		if(*ptr == '{')
+		{
+			auto const tag = anon::scanner::type_tag(element_begin, ptr);
+			if(tag == "obj" || tag == "obj*")
+			{
+				++level;
+				++ptr;
+			}
+			else
+			{ ptr = anon::scanner::skip_value(ptr + 1, end); }
+			continue;
+		}
+
+		if(end - ptr < 2)
+		{ throw std::runtime_error{"Empty or incomplete value"}; }
+
+		switch(ptr[1])
+		{
+			case '}':
+				--level;
+				if(level == 0)
+				{
+					if(!std::all_of(element_begin, ptr, is_whitespace))
+					{ throw std::runtime_error{"Non-terminated array element"}; }
+					return ret;
+				}
+				break;
+
+			case ';':
+				if(level == 1)
+				{
+					ret.push_back(std::span{element_begin, ptr});
+					element_begin = ptr + 2;
+				}
+				break;
+		}
+		ptr += 2;
+	}
+}
@@ -0,0 +1,159 @@
+//@	{"dependencies_extra":[{"ref":"./parallel_loader.o","rel":"implementation"}]}
+
+#ifndef ANON_PARALLELLOADER_HPP
+#define ANON_PARALLELLOADER_HPP
+
+/**
+ * \file parallel_loader.hpp
+ *
+ * \brief Contains functions for loading large arrays of objects on multiple threads
+ */
+
+#include "./deserializer.hpp"
+#include "./mmap_source.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace anon
+{
+	/**
+	 * \brief Finds the elements of the `obj*` array at the start of input
+	 *
+	 * This function performs a quick scan of input, that only tracks the nesting level. Values
+	 * whose type tag is `obj` or `obj*` increase the level, while the contents of all other values
+	 * are skipped until their closing `\}`. Each `\;` at the outermost level terminates an element.
+	 *
+	 * \return The body of each element, without the terminating `\;`. Any data after the end of the
+	 * array is ignored.
+	 *
+	 * \note The elements themselves are not validated. This happens when they are parsed. Only
+	 * whitespace may precede the type tag, which must be `obj*`.
+	 *
+	 * \ingroup de-serialization
+	 */
+	std::vector<std::span<char const>> split_object_array(std::span<char const> input);
+
+	namespace parallel_loader_detail
+	{
+		template<class Object>
+		void load_elements(std::span<std::span<char const> const> elements, std::vector<Object>& ret)
+		{
+			constexpr std::string_view begin_element{"obj{"};
+			constexpr std::string_view end_element{"\\}"};
+
+			auto ctxt = create_parser_context<Object>();
+			ret.reserve(std::size(elements));
+			for(auto element : elements)
+			{
+				update(std::span{std::data(begin_element), std::size(begin_element)}, *ctxt);
+				if(update(element, *ctxt).status == parse_result::done)
+				{ throw std::runtime_error{"Unbalanced array element"}; }
+
+				auto const res = update(std::span{std::data(end_element), std::size(end_element)}, *ctxt);
+				if(res.status != parse_result::done)
+				{ throw std::runtime_error{"Non-terminated array element"}; }
+
+				ret.push_back(std::get<Object>(take_result_and_reset(*ctxt)));
+			}
+		}
+	}
+
+	/**
+	 * \brief Loads an `obj*` array from input, using num_workers threads
+	 *
+	 * The elements are located by split_object_array, and then divided into num_workers groups of
+	 * roughly the same size in bytes. Each group is parsed on its own thread, with its own parser
+	 * context. Finally, the results are joined in their original order.
+	 *
+	 * \note All values are allocated with the default allocator of Object, since a single memory
+	 * resource would need to be thread-safe
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class Object = object>
+	std::vector<Object> load_parallel(std::span<char const> input,
+		size_t num_workers = std::thread::hardware_concurrency())
+	{
+		auto const elements = split_object_array(input);
+		if(std::size(elements) == 0)
+		{ return std::vector<Object>{}; }
+
+		num_workers = std::clamp(num_workers, static_cast<size_t>(1), std::size(elements));
+		if(num_workers == 1)
+		{
+			std::vector<Object> ret;
+			parallel_loader_detail::load_elements<Object>(elements, ret);
+			return ret;
+		}
+
+		// Give each worker a contiguous range of elements, so that the ranges have roughly the
+		// same size in bytes
+		auto const total_size = static_cast<size_t>(std::data(elements.back()) + std::size(elements.back())
+			- std::data(elements.front()));
+		std::vector<size_t> ranges{0};
+		for(size_t k = 0; k != std::size(elements); ++k)
+		{
+			auto const offset = static_cast<size_t>(std::data(elements[k]) - std::data(elements.front()));
+			if(offset >= std::size(ranges)*total_size/num_workers && k != ranges.back())
+			{ ranges.push_back(k); }
+		}
+		ranges.push_back(std::size(elements));
+
+		auto const num_ranges = std::size(ranges) - 1;
+		std::vector<std::vector<Object>> results(num_ranges);
+		std::vector<std::exception_ptr> errors(num_ranges);
+		{
+			std::vector<std::jthread> workers;
+			workers.reserve(num_ranges);
+			for(size_t k = 0; k != num_ranges; ++k)
+			{
+				workers.emplace_back([&elements, &ranges, &results, &errors, k]() {
+					try
+					{
+						parallel_loader_detail::load_elements<Object>(
+							std::span{std::data(elements) + ranges[k], std::data(elements) + ranges[k + 1]},
+							results[k]);
+					}
+					catch(...)
+					{ errors[k] = std::current_exception(); }
+				});
+			}
+		}
+
+		for(auto const& error : errors)
+		{
+			if(error != nullptr)
+			{ std::rethrow_exception(error); }
+		}
+
+		std::vector<Object> ret;
+		ret.reserve(std::size(elements));
+		for(auto& result : results)
+		{ std::ranges::move(result, std::back_inserter(ret)); }
+		return ret;
+	}
+
+	/**
+	 * \brief Loads an `obj*` array from the file referred to by path, using num_workers threads
+	 *
+	 * The file is mapped into memory by an mmap_source, and then loaded as by
+	 * load_parallel(std::span<char const>, size_t)
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class Object = object>
+	std::vector<Object> load_parallel(std::filesystem::path const& path,
+		size_t num_workers = std::thread::hardware_concurrency())
+	{
+		mmap_source src{path};
+		return load_parallel<Object>(src.data(), num_workers);
+	}
+}
+
+#endif
@@ -0,0 +1,122 @@
+//@	{"target":{"name":"parallel_loader.test"}}
+
+#include "./parallel_loader.hpp"
+#include "./serializer.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+namespace
+{
+	struct chunked_buffer
+	{
+		std::string_view data;
+		bool done{false};
+	};
+
+	anon::chunk_read_result read_chunk(chunked_buffer& buff)
+	{
+		if(buff.done)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::eof}; }
+
+		buff.done = true;
+		return anon::chunk_read_result{std::span{std::data(buff.data), std::size(buff.data)},
+			anon::stream_status::ready};
+	}
+
+	std::string make_array(size_t n)
+	{
+		std::string ret{"obj*{\n"};
+		for(size_t k = 0; k != n; ++k)
+		{
+			auto const index = std::to_string(k);
+			ret.append("\tindex: u64{").append(index).append("\\}\n")
+				.append("\ta_string: str{Looks like obj{ but is a string with \\\\ and { \\}\n")
+				.append("\tnested: obj{values: i32*{1\\;2\\;").append(index).append("\\;\\} empty: obj{\\}\\}\n")
+				.append("\tobjects: obj*{a: str{obj*{\\}\\;b:obj{c:str*{x\\;y\\;\\}\\}\\;\\;\\}\n");
+			if(k % 3 == 0)
+			{ ret.append("\tsometimes: f64{").append(index).append("\\}\n"); }
+			ret.append("\\;\n");
+		}
+		ret.append("\\;\\}trailing data");
+		return ret;
+	}
+}
+
+TESTCASE(anon_split_object_array)
+{
+	std::string_view const src{R"(  obj* {a: i32{1\}\;b: obj{c: str{{\}\}\;  \;\})"};
+	auto const elements = anon::split_object_array(std::span{std::data(src), std::size(src)});
+	REQUIRE_EQ(std::size(elements), 3);
+	EXPECT_EQ((std::string_view{std::begin(elements[0]), std::end(elements[0])}), R"(a: i32{1\})");
+	EXPECT_EQ((std::string_view{std::begin(elements[1]), std::end(elements[1])}), R"(b: obj{c: str{{\}\})");
+	EXPECT_EQ((std::string_view{std::begin(elements[2]), std::end(elements[2])}), "  ");
+}
+
+TESTCASE(anon_load_parallel)
+{
+	auto const src = make_array(1000);
+	chunked_buffer buff{src};
+	auto const expected = anon::load<std::vector<anon::object>>(buff);
+	REQUIRE_EQ(std::size(expected), 1001);
+
+	for(size_t num_workers : {0, 1, 2, 3, 8, 2000})
+	{
+		auto const result = anon::load_parallel(std::span{std::data(src), std::size(src)}, num_workers);
+		REQUIRE_EQ(std::size(result), std::size(expected));
+		for(size_t k = 0; k != std::size(result); ++k)
+		{
+			if(anon::to_string(result[k]) != anon::to_string(expected[k]))
+			{ testcaseFailed(); }
+		}
+	}
+
+	auto const result = anon::load_parallel<anon::map_object>(std::span{std::data(src), std::size(src)}, 4);
+	REQUIRE_EQ(std::size(result), std::size(expected));
+	EXPECT_EQ(std::get<uint64_t>(result[999].find(anon::property_name{"index"})->second), 999);
+}
+
+TESTCASE(anon_load_parallel_errors)
+{
+	for(auto const src : {R"(obj{a: i32{1\}\})", R"(obj*{a: i32{1\}\})", R"(obj*{a: i32{1\}\;)",
+		R"(obj*{a: i32{1\}\}\;\})", R"(obj*{a: i32{x\}\;\})", R"(obj*{a: str{1\;\})"})
+	{
+		try
+		{
+			std::string_view const str{src};
+			(void)anon::load_parallel(std::span{std::data(str), std::size(str)}, 2);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+}
+
+TESTCASE(anon_load_parallel_type_tag)
+{
+	for(auto const src : {R"(junk obj*{a: i32{1\}\;\})", R"(xobj*{a: i32{1\}\;\})",
+		R"(obj* x{a: i32{1\}\;\})", R"(a: obj*{\;\})", R"(foo{\})", "  obj*  "})
+	{
+		std::string sequential_error;
+		try
+		{
+			chunked_buffer buff{src};
+			(void)anon::load<std::vector<anon::object>>(buff);
+		}
+		catch(std::runtime_error const& err)
+		{ sequential_error = err.what(); }
+		EXPECT_NE(sequential_error, "");
+
+		try
+		{
+			std::string_view const str{src};
+			(void)anon::load_parallel(std::span{std::data(str), std::size(str)}, 2);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const& err)
+		{ EXPECT_EQ(err.what(), sequential_error); }
+	}
+
+	std::string_view const src{" \n\tobj*\n{a: i32{1\\}\\;\\}"};
+	auto const result = anon::load_parallel(std::span{std::data(src), std::size(src)}, 2);
+	REQUIRE_EQ(std::size(result), 1);
+}
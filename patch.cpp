@@ -0,0 +1,273 @@
+//@	{"target":{"name":"patch.o"}}
+
+#include "./patch.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+namespace
+{
+	template<class T>
+	struct is_array : std::false_type
+	{};
+
+	template<class T, class Allocator>
+	struct is_array<std::vector<T, Allocator>> : std::true_type
+	{};
+
+	class differ
+	{
+	public:
+		explicit differ(anon::patch& changes):m_changes{changes}
+		{}
+
+		void compare(anon::object const& a, anon::object const& b)
+		{
+			auto i = std::begin(a);
+			auto j = std::begin(b);
+			while(i != std::end(a) || j != std::end(b))
+			{
+				if(j == std::end(b) || (i != std::end(a) && i->first < j->first))
+				{
+					emit(anon::patch_operation{anon::patch_op::remove, path_to(i->first)});
+					++i;
+				}
+				else
+				if(i == std::end(a) || j->first < i->first)
+				{
+					emit(anon::patch_operation{anon::patch_op::set, path_to(j->first), j->second});
+					++j;
+				}
+				else
+				{
+					compare(i->first, i->second, j->second);
+					++i;
+					++j;
+				}
+			}
+		}
+
+	private:
+		anon::patch& m_changes;
+		std::vector<anon::property_name> m_path;
+
+		std::vector<anon::property_name> path_to(anon::property_name const& key) const
+		{
+			auto ret = m_path;
+			ret.push_back(key);
+			return ret;
+		}
+
+		void emit(anon::patch_operation&& operation)
+		{ m_changes.push_back(std::move(operation)); }
+
+		void compare(anon::property_name const& key, anon::object::mapped_type const& a,
+			anon::object::mapped_type const& b)
+		{
+			std::visit([this, &key, &b]<class T, class U>(T const& a_val, U const& b_val) {
+				if constexpr(std::is_same_v<T, U> && std::is_same_v<T, anon::object>)
+				{
+					m_path.push_back(key);
+					compare(a_val, b_val);
+					m_path.pop_back();
+				}
+				else
+				if constexpr(std::is_same_v<T, U> && is_array<T>::value && !std::is_same_v<T, std::string>)
+				{
+					if(a_val != b_val)
+					{ splice(key, a_val, b_val); }
+				}
+				else
+				if constexpr(std::is_same_v<T, U>)
+				{
+					if(a_val != b_val)
+					{ emit(anon::patch_operation{anon::patch_op::set, path_to(key), b}); }
+				}
+				else
+				{ emit(anon::patch_operation{anon::patch_op::set, path_to(key), b}); }
+			}, a, b);
+		}
+
+		template<class T>
+		void splice(anon::property_name const& key, std::vector<T> const& a, std::vector<T> const& b)
+		{
+			auto const common = std::min(std::size(a), std::size(b));
+			auto const prefix = static_cast<size_t>(
+				std::mismatch(std::begin(a), std::begin(a) + common, std::begin(b)).first - std::begin(a));
+
+			size_t suffix = 0;
+			while(suffix != common - prefix && a[std::size(a) - 1 - suffix] == b[std::size(b) - 1 - suffix])
+			{ ++suffix; }
+
+			// Without any common elements, replacing the entire array is more compact
+			if(prefix == 0 && suffix == 0)
+			{
+				emit(anon::patch_operation{anon::patch_op::set, path_to(key), b});
+				return;
+			}
+
+			emit(anon::patch_operation{anon::patch_op::splice, path_to(key),
+				std::vector<T>(std::begin(b) + prefix, std::end(b) - suffix),
+				prefix,
+				std::size(a) - prefix - suffix});
+		}
+	};
+
+	void splice(anon::object::mapped_type& target, anon::patch_operation const& operation)
+	{
+		std::visit([&operation]<class T, class U>(T& array, U const& values) {
+			if constexpr(std::is_same_v<T, U> && is_array<T>::value && !std::is_same_v<T, std::string>)
+			{
+				if(operation.offset > std::size(array)
+					|| operation.remove_count > std::size(array) - operation.offset)
+				{ throw std::runtime_error{"Splice is out of range"}; }
+
+				auto const begin = std::begin(array) + operation.offset;
+				auto const i = array.erase(begin, begin + operation.remove_count);
+				array.insert(i, std::begin(values), std::end(values));
+			}
+			else
+			{ throw std::runtime_error{"Splice requires arrays of the same type"}; }
+		}, target, operation.value);
+	}
+
+	char const* op_name(anon::patch_op op)
+	{
+		switch(op)
+		{
+			case anon::patch_op::set:
+				return "set";
+			case anon::patch_op::remove:
+				return "remove";
+			case anon::patch_op::splice:
+				return "splice";
+		}
+		__builtin_unreachable();
+	}
+
+	anon::patch_op op_from_name(std::string_view name)
+	{
+		if(name == "set")
+		{ return anon::patch_op::set; }
+		if(name == "remove")
+		{ return anon::patch_op::remove; }
+		if(name == "splice")
+		{ return anon::patch_op::splice; }
+		throw std::runtime_error{std::string{"Unsupported patch operation '"}.append(name).append("'")};
+	}
+
+	anon::object::mapped_type const& field(anon::object const& operation, std::string_view name)
+	{
+		if(auto const i = operation.find(name); i != std::end(operation))
+		{ return i->second; }
+		throw std::runtime_error{std::string{"Patch operation has no field '"}.append(name).append("'")};
+	}
+
+	template<class T>
+	T const& field_as(anon::object const& operation, std::string_view name)
+	{
+		if(auto const value = std::get_if<T>(&field(operation, name)); value != nullptr)
+		{ return *value; }
+		throw std::runtime_error{std::string{"Patch operation field '"}.append(name)
+			.append("' should be ").append(anon::type_info<T>::name())};
+	}
+}
+
+anon::patch anon::diff(object const& a, object const& b)
+{
+	patch ret;
+	differ{ret}.compare(a, b);
+	return ret;
+}
+
+void anon::apply_patch(object& obj, patch const& changes)
+{
+	for(auto const& operation : changes)
+	{
+		if(std::size(operation.path) == 0)
+		{ throw std::runtime_error{"Empty patch path"}; }
+
+		auto current = &obj;
+		for(size_t k = 0; k != std::size(operation.path) - 1; ++k)
+		{
+			auto const i = current->find(operation.path[k]);
+			current = i != std::end(*current)? std::get_if<object>(&i->second) : nullptr;
+			if(current == nullptr)
+			{
+				throw std::runtime_error{std::string{"Patch path does not refer to an object at '"}
+					.append(std::string_view{operation.path[k]}).append("'")};
+			}
+		}
+
+		auto const& key = operation.path.back();
+		switch(operation.op)
+		{
+			case patch_op::set:
+				current->insert_or_assign(property_name{key}, operation.value);
+				break;
+
+			case patch_op::remove:
+				if(!current->erase(key))
+				{ throw std::runtime_error{"Key not found"}; }
+				break;
+
+			case patch_op::splice:
+				splice((*current)[key], operation);
+				break;
+		}
+	}
+}
+
+std::vector<anon::object> anon::to_objects(patch const& changes)
+{
+	std::vector<object> ret;
+	ret.reserve(std::size(changes));
+	for(auto const& operation : changes)
+	{
+		object item;
+		item.insert(property_name{"op"}, std::string{op_name(operation.op)});
+
+		std::vector<std::string> path;
+		for(auto const& name : operation.path)
+		{ path.emplace_back(name); }
+		item.insert(property_name{"path"}, std::move(path));
+
+		if(operation.op != patch_op::remove)
+		{ item.insert(property_name{"value"}, operation.value); }
+
+		if(operation.op == patch_op::splice)
+		{
+			item.insert(property_name{"offset"}, static_cast<uint64_t>(operation.offset));
+			item.insert(property_name{"remove"}, static_cast<uint64_t>(operation.remove_count));
+		}
+		ret.push_back(std::move(item));
+	}
+	return ret;
+}
+
+anon::patch anon::to_patch(std::vector<object> const& operations)
+{
+	patch ret;
+	ret.reserve(std::size(operations));
+	for(auto const& item : operations)
+	{
+		patch_operation operation{op_from_name(field_as<std::string>(item, "op")), {}};
+		for(auto const& name : field_as<std::vector<std::string>>(item, "path"))
+		{ operation.path.push_back(property_name{name}); }
+
+		if(operation.op != patch_op::remove)
+		{ operation.value = field(item, "value"); }
+
+		if(operation.op == patch_op::splice)
+		{
+			operation.offset = field_as<uint64_t>(item, "offset");
+			operation.remove_count = field_as<uint64_t>(item, "remove");
+		}
+		ret.push_back(std::move(operation));
+	}
+	return ret;
+}
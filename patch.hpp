@@ -0,0 +1,164 @@
+//@	{"dependencies_extra":[{"ref":"./patch.o","rel":"implementation"}]}
+
+#ifndef ANON_PATCH_HPP
+#define ANON_PATCH_HPP
+
+/**
+ * \file patch.hpp
+ *
+ * \brief Contains functions for computing and applying differences between objects
+ */
+
+#include "./object.hpp"
+#include "./property_name.hpp"
+#include "./serializer.hpp"
+#include "./deserializer.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * \defgroup patch Structural diff and patch
+ *
+ * \brief This module makes it possible to send the changes made to an object, rather than the
+ * entire object
+ *
+ * A patch is a sequence of operations, each of which refers to a property through a path of
+ * property names, starting at the outermost object:
+ *
+ * * `set` inserts the property, or replaces its value
+ *
+ * * `remove` removes the property
+ *
+ * * `splice` replaces remove_count elements starting at offset, of the array held by the
+ *   property, with the elements of value
+ *
+ * In text form, a patch is stored as an `obj*`, with one element per operation. Like for any
+ * object, the properties of an element are written in sorted order. For example, a patch that
+ * sets `settings.port` to 8080, removes `legacy`, and replaces the element at offset 3 of `rows`
+ * with 5, is written as follows, with line breaks added after each element:
+ *
+ * ```
+ * obj*{op:str{set\}path:str*{settings\;port\;\}value:u32{8080\}\;
+ * op:str{remove\}path:str*{legacy\;\}\;
+ * offset:u64{3\}op:str{splice\}path:str*{rows\;\}remove:u64{1\}value:i32*{5\;\}\;\}
+ * ```
+ */
+
+namespace anon
+{
+	/**
+	 * \brief The kind of a patch_operation
+	 *
+	 * \ingroup patch
+	 */
+	enum class patch_op{set, remove, splice};
+
+	/**
+	 * \brief A single change to an object
+	 *
+	 * \ingroup patch
+	 */
+	struct patch_operation
+	{
+		patch_op op;
+
+		/**
+		 * \brief The property names leading to the property to change
+		 */
+		std::vector<property_name> path;
+
+		/**
+		 * \brief The new value for set, or the array of elements to insert for splice
+		 */
+		object::mapped_type value{};
+
+		/**
+		 * \brief The index of the first element to replace by splice
+		 */
+		size_t offset{0};
+
+		/**
+		 * \brief The number of elements to replace by splice
+		 */
+		size_t remove_count{0};
+
+		bool operator==(patch_operation const&) const = default;
+	};
+
+	/**
+	 * \brief A sequence of changes to an object
+	 *
+	 * \ingroup patch
+	 */
+	using patch = std::vector<patch_operation>;
+
+	/**
+	 * \brief Computes a patch that turns a into b
+	 *
+	 * Since the properties of an object are sorted by name, both objects are walked in a single
+	 * merge pass. Nested objects are compared recursively. If both values are arrays of the same
+	 * type, a single splice covering everything between their common prefix and suffix is
+	 * emitted. All other changed values are replaced by set.
+	 *
+	 * \ingroup patch
+	 */
+	patch diff(object const& a, object const& b);
+
+	/**
+	 * \brief Applies all operations in changes to obj
+	 *
+	 * \note If an operation does not fit obj, an exception is thrown. In this case, operations
+	 * before the failing operation have already been applied.
+	 *
+	 * \ingroup patch
+	 */
+	void apply_patch(object& obj, patch const& changes);
+
+	/**
+	 * \brief Converts changes to its object representation, with one object per operation
+	 *
+	 * \ingroup patch
+	 */
+	std::vector<object> to_objects(patch const& changes);
+
+	/**
+	 * \brief Converts the object representation of a patch back to a patch
+	 *
+	 * \ingroup patch
+	 */
+	patch to_patch(std::vector<object> const& operations);
+
+	/**
+	 * \brief Writes changes to sink, as an `obj*`
+	 *
+	 * \ingroup patch
+	 */
+	template<sink Sink>
+	void store_patch(patch const& changes, Sink&& sink)
+	{ store(to_objects(changes), sink); }
+
+	/**
+	 * \brief Generates the text representation of changes
+	 *
+	 * \ingroup patch
+	 */
+	inline std::string to_string(patch const& changes)
+	{
+		std::string ret;
+		store_patch(changes, string_writer{ret});
+		return ret;
+	}
+
+	/**
+	 * \brief Loads a patch from src
+	 *
+	 * \ingroup patch
+	 */
+	template<source Source>
+	patch load_patch(Source&& src)
+	{ return to_patch(load<std::vector<object>>(std::forward<Source>(src))); }
+}
+
+#endif
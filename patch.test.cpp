@@ -0,0 +1,179 @@
+//@	{"target":{"name":"patch.test"}}
+
+#include "./patch.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+namespace
+{
+	struct buffer
+	{
+		std::string_view data;
+		bool done{false};
+	};
+
+	anon::chunk_read_result read_chunk(buffer& buff)
+	{
+		if(buff.done)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::eof}; }
+
+		buff.done = true;
+		return anon::chunk_read_result{std::span{std::data(buff.data), std::size(buff.data)},
+			anon::stream_status::ready};
+	}
+
+	anon::object parse(std::string_view src)
+	{
+		buffer buff{src};
+		return anon::load(buff);
+	}
+
+	constexpr std::string_view old_version{R"(obj{
+	legacy: str{Remove me\}
+	name: str{Test\}
+	rows: i32*{1\;2\;3\;4\;5\;\}
+	settings: obj{
+		network: obj{port: u32{80\} host: str{localhost\}\}
+		colors: str*{red\;green\;\}
+	\}
+	tags: str*{a\;b\;\}
+	type_change: i32{1\}
+\})"};
+
+	constexpr std::string_view new_version{R"(obj{
+	added: f64{1.5\}
+	name: str{Test\}
+	rows: i32*{1\;2\;9\;9\;4\;5\;\}
+	settings: obj{
+		network: obj{port: u32{8080\} host: str{localhost\}\}
+		colors: str*{red\;green\;blue\;\}
+	\}
+	tags: str*{c\;\}
+	type_change: str{1\}
+\})"};
+}
+
+TESTCASE(anon_patch_diff)
+{
+	auto const a = parse(old_version);
+	auto const b = parse(new_version);
+	auto const changes = anon::diff(a, b);
+	REQUIRE_EQ(std::size(changes), 7);
+
+	EXPECT_EQ(changes[0].op, anon::patch_op::set);
+	EXPECT_EQ(std::string_view{changes[0].path.back()}, "added");
+
+	EXPECT_EQ(changes[1].op, anon::patch_op::remove);
+	EXPECT_EQ(std::string_view{changes[1].path.back()}, "legacy");
+
+	EXPECT_EQ(changes[2].op, anon::patch_op::splice);
+	EXPECT_EQ(changes[2].offset, 2);
+	EXPECT_EQ(changes[2].remove_count, 1);
+	EXPECT_EQ(std::get<std::vector<int32_t>>(changes[2].value), (std::vector<int32_t>{9, 9}));
+
+	EXPECT_EQ(changes[3].op, anon::patch_op::splice);
+	EXPECT_EQ(std::size(changes[3].path), 2);
+	EXPECT_EQ(changes[3].offset, 2);
+	EXPECT_EQ(changes[3].remove_count, 0);
+
+	EXPECT_EQ(changes[4].op, anon::patch_op::set);
+	EXPECT_EQ(std::size(changes[4].path), 3);
+	EXPECT_EQ(std::get<uint32_t>(changes[4].value), 8080);
+
+	EXPECT_EQ(changes[5].op, anon::patch_op::set);
+	EXPECT_EQ(std::string_view{changes[5].path.back()}, "tags");
+
+	EXPECT_EQ(changes[6].op, anon::patch_op::set);
+	EXPECT_EQ(std::get<std::string>(changes[6].value), "1");
+
+	EXPECT_EQ(std::size(anon::diff(a, a)), 0);
+}
+
+TESTCASE(anon_patch_apply)
+{
+	auto const b = parse(new_version);
+	auto a = parse(old_version);
+	anon::apply_patch(a, anon::diff(a, b));
+	EXPECT_EQ(a, b);
+
+	auto c = b;
+	anon::apply_patch(c, anon::diff(b, anon::object{}));
+	EXPECT_EQ(std::size(c), 0);
+	anon::apply_patch(c, anon::diff(anon::object{}, b));
+	EXPECT_EQ(c, b);
+}
+
+TESTCASE(anon_patch_store_load)
+{
+	auto const a = parse(old_version);
+	auto const b = parse(new_version);
+	auto const changes = anon::diff(a, b);
+
+	auto const str = anon::to_string(changes);
+	buffer buff{str};
+	auto const loaded = anon::load_patch(buff);
+	EXPECT_EQ(loaded, changes);
+
+	anon::patch const remove{anon::patch_operation{anon::patch_op::remove,
+		std::vector{anon::property_name{"legacy"}}}};
+	EXPECT_EQ(anon::to_string(remove), R"(obj*{op:str{remove\}path:str*{legacy\;\}\;\})");
+}
+
+TESTCASE(anon_patch_apply_errors)
+{
+	std::vector<anon::patch> const patches{
+		{anon::patch_operation{anon::patch_op::remove, {anon::property_name{"missing"}}}},
+		{anon::patch_operation{anon::patch_op::set, {}, int32_t{1}}},
+		{anon::patch_operation{anon::patch_op::set, {anon::property_name{"name"}, anon::property_name{"a"}},
+			int32_t{1}}},
+		{anon::patch_operation{anon::patch_op::splice, {anon::property_name{"rows"}},
+			std::vector<int32_t>{1}, 5, 1}},
+		{anon::patch_operation{anon::patch_op::splice, {anon::property_name{"rows"}},
+			std::vector<double>{1.0}, 0, 1}},
+		{anon::patch_operation{anon::patch_op::splice, {anon::property_name{"name"}},
+			std::string{"x"}, 0, 1}}
+	};
+
+	for(auto const& changes : patches)
+	{
+		auto obj = parse(old_version);
+		try
+		{
+			anon::apply_patch(obj, changes);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+}
+
+TESTCASE(anon_patch_load_errors)
+{
+	for(auto const src : {
+		R"(obj*{path: str*{a\;\} value: i32{1\}\;\})",
+		R"(obj*{op: i32{1\} path: str*{a\;\} value: i32{1\}\;\})",
+		R"(obj*{op: str{set\} path: str{a\} value: i32{1\}\;\})",
+		R"(obj*{op: str{set\} path: str*{a\;\}\;\})",
+		R"(obj*{op: str{splice\} path: str*{a\;\} offset: i32{0\} remove: u64{1\} value: i32*{\}\;\})",
+		R"(obj*{op: str{splice\} path: str*{a\;\} offset: u64{0\} value: i32*{\}\;\})",
+		R"(obj*{op: str{move\} path: str*{a\;\}\;\})"})
+	{
+		try
+		{
+			buffer buff{src};
+			(void)anon::load_patch(buff);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+
+	try
+	{
+		buffer buff{R"(obj*{op: str{set\} path: i32*{1\;\} value: i32{1\}\;\})"};
+		(void)anon::load_patch(buff);
+		testcaseFailed();
+	}
+	catch(std::runtime_error const& err)
+	{ EXPECT_EQ(std::string_view{err.what()}, "Patch operation field 'path' should be str*"); }
+}
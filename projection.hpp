@@ -0,0 +1,253 @@
+#ifndef ANON_PROJECTION_HPP
+#define ANON_PROJECTION_HPP
+
+/**
+ * \file projection.hpp
+ *
+ * \brief Contains functionality for loading only selected parts of an object
+ */
+
+#include "./object.hpp"
+#include "./property_name.hpp"
+#include "./event_parser.hpp"
+#include "./dom_builder.hpp"
+#include "./deserializer.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <map>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace anon
+{
+	/**
+	 * \brief A set of key paths, that selects which parts of an object to load
+	 *
+	 * A key path is a sequence of property names separated by `.`, such as
+	 * `settings.network.port`. The value at the end of a path is loaded in its entirety, together
+	 * with the objects leading to it. Arrays of objects are transparent, so `users.name` selects the
+	 * name of every object in the array `users`. A key path with an empty property name results in
+	 * an exception.
+	 *
+	 * \ingroup de-serialization
+	 */
+	class projection
+	{
+	public:
+		/**
+		 * \brief Indicates that everything below a node is selected
+		 */
+		static constexpr size_t select_all = std::numeric_limits<size_t>::max();
+
+		explicit projection(std::span<std::string_view const> paths):m_nodes(1)
+		{
+			for(auto path : paths)
+			{ add(path); }
+		}
+
+		projection(std::initializer_list<std::string_view> paths):
+			projection{std::span{std::begin(paths), std::size(paths)}}
+		{}
+
+		/**
+		 * \brief Returns the node of the outermost object
+		 */
+		size_t root() const
+		{ return 0; }
+
+		/**
+		 * \brief Looks up the property name within node
+		 *
+		 * \return std::nullopt if the property is not selected, select_all if the entire value is
+		 * selected, and otherwise the node that selects parts of the value
+		 */
+		std::optional<size_t> select(size_t node, std::string_view name) const
+		{
+			auto const& children = m_nodes[node].children;
+			auto const i = children.find(name);
+			if(i == std::end(children))
+			{ return std::nullopt; }
+			return i->second;
+		}
+
+	private:
+		struct node
+		{
+			std::map<std::string, size_t, std::less<>> children;
+		};
+
+		std::vector<node> m_nodes;
+
+		void add(std::string_view path)
+		{
+			size_t current = root();
+			while(true)
+			{
+				auto const sep = path.find('.');
+				auto const component = path.substr(0, sep);
+				if(std::size(component) == 0)
+				{ throw std::runtime_error{"Empty property name in key path"}; }
+
+				auto const name = std::string{property_name{component}};
+				auto& children = m_nodes[current].children;
+				auto const last = sep == std::string_view::npos;
+				auto i = children.find(name);
+				if(i == std::end(children))
+				{
+					auto const index = last? select_all : std::size(m_nodes);
+					children.emplace(name, index);
+					if(last)
+					{ return; }
+					m_nodes.push_back(node{});
+					current = index;
+				}
+				else
+				{
+					if(last)
+					{
+						// A shorter path selects everything the longer path selects
+						i->second = select_all;
+						return;
+					}
+
+					if(i->second == select_all)
+					{ return; }
+					current = i->second;
+				}
+				path = path.substr(sep + 1);
+			}
+		}
+	};
+
+	/**
+	 * \brief An event handler that builds only the parts of an object that are selected by a
+	 * projection
+	 *
+	 * Properties that are not selected are skipped by the event_parser, so no memory is allocated
+	 * for them.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class Object>
+	class projecting_builder
+	{
+	public:
+		explicit projecting_builder(projection const& paths, typename Object::allocator_type const& alloc = {}):
+			m_paths{paths},
+			m_builder{alloc},
+			m_pending{paths.root()}
+		{}
+
+		bool on_key(std::string_view name)
+		{
+			auto const current = std::size(m_nodes) != 0? m_nodes.back().node : m_paths.root();
+			if(current != projection::select_all)
+			{
+				auto const selected = m_paths.select(current, name);
+				if(!selected.has_value())
+				{ return false; }
+				m_pending = *selected;
+			}
+			else
+			{ m_pending = projection::select_all; }
+
+			m_builder.on_key(name);
+			return true;
+		}
+
+		void on_begin_object()
+		{
+			if(std::size(m_nodes) == 0)
+			{ m_nodes.push_back(level{m_paths.root(), false}); }
+			else
+			if(m_nodes.back().is_array)
+			{ m_nodes.push_back(level{m_nodes.back().node, false}); }
+			else
+			{ m_nodes.push_back(level{m_pending, false}); }
+			m_builder.on_begin_object();
+		}
+
+		void on_end_object()
+		{
+			m_nodes.pop_back();
+			m_builder.on_end_object();
+		}
+
+		template<class T>
+		void on_begin_array(std::type_identity<T> type)
+		{
+			m_nodes.push_back(level{std::size(m_nodes) != 0? m_pending : m_paths.root(), true});
+			m_builder.on_begin_array(type);
+		}
+
+		void on_end_array()
+		{
+			m_nodes.pop_back();
+			m_builder.on_end_array();
+		}
+
+		template<class T>
+		void on_scalar(T value)
+		{ m_builder.on_scalar(value); }
+
+		template<class T>
+		void on_array_element(T value)
+		{ m_builder.on_array_element(value); }
+
+		template<class T>
+		void on_array_elements(std::span<T const> values)
+		{ m_builder.on_array_elements(values); }
+
+		/**
+		 * \brief Moves the most recently completed value out of this projecting_builder
+		 */
+		auto take_result()
+		{ return m_builder.take_result(); }
+
+	private:
+		struct level
+		{
+			size_t node;
+			bool is_array;
+		};
+
+		projection const& m_paths;
+		dom_builder<Object> m_builder;
+		std::vector<level> m_nodes;
+		size_t m_pending;
+	};
+
+	/**
+	 * \brief Loads the parts of an object from src that are selected by paths
+	 *
+	 * Properties that are not on any of the paths are skipped by scanning for control sequences.
+	 * Their contents are not decoded, and no memory is allocated for them. Objects leading to a
+	 * selected value are always created, even if they end up empty.
+	 *
+	 * \note If a path continues into a value that is not an object, or an array of objects, that
+	 * value is loaded in its entirety
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class T = object, source Source>
+	T load(Source&& src, projection const& paths)
+	{
+		event_parser parser{projecting_builder<typename deserializer_detail::object_type_of<T>::type>{paths}};
+		std::span<char const> pending;
+		while(!deserializer_detail::feed(src, pending, [&parser](auto input) {
+			return parser.update(input);
+		}))
+		{}
+		return std::get<T>(parser.handler().take_result());
+	}
+}
+
+#endif
@@ -0,0 +1,156 @@
+//@	{"target":{"name":"projection.test"}}
+
+#include "./projection.hpp"
+#include "./serializer.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+namespace
+{
+	struct buffer
+	{
+		explicit buffer(std::string_view sv):data{sv}, ptr{std::begin(data)}
+		{}
+
+		std::string_view data;
+		char const* ptr;
+	};
+
+	anon::read_result read_byte(buffer& buff)
+	{
+		auto ret_val = buff.ptr != std::end(buff.data)? *buff.ptr : '\0';
+		auto ret_status = buff.ptr != std::end(buff.data) ?
+			anon::stream_status::ready: anon::stream_status::eof;
+		++buff.ptr;
+
+		return anon::read_result{ret_val, ret_status};
+	}
+
+	struct chunked_buffer
+	{
+		explicit chunked_buffer(std::string_view sv, size_t chunk_size):
+			data{sv},
+			ptr{std::begin(data)},
+			chunk_size{chunk_size}
+		{}
+
+		std::string_view data;
+		char const* ptr;
+		size_t chunk_size;
+	};
+
+	anon::chunk_read_result read_chunk(chunked_buffer& buff)
+	{
+		auto const n = std::min(buff.chunk_size, static_cast<size_t>(std::end(buff.data) - buff.ptr));
+		if(n == 0)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::eof}; }
+
+		auto const ret = std::span{buff.ptr, n};
+		buff.ptr += n;
+		return anon::chunk_read_result{ret, anon::stream_status::ready};
+	}
+
+	constexpr std::string_view test_data{R"(obj{
+	name: str{Test\}
+	blob: str{Contains obj{ and \\\}
+	settings: obj{
+		network: obj{
+			port: u32{8080\}
+			host: str{localhost\}
+			retries: i32*{1\;2\;3\;\}
+		\}
+		colors: obj*{
+			fg: str{obj*{\}
+			bg: obj {value:str{black\}\}\;
+			fg: str{white\}\;\}
+	\}
+	users: obj*{
+		name: str{Alice\}
+		age: u32{30\}
+		tags: str*{a\;b\;\}\;
+		name: str{Bob\}
+		misc: obj*{a: obj{\}\;\}\;
+		age: u32{40\}\;\}
+	values: f64*{1\;2\;3\;\}
+\})"};
+
+	constexpr std::string_view expected{R"(obj{
+	settings: obj{
+		network: obj{
+			port: u32{8080\}
+		\}
+	\}
+	users: obj*{
+		name: str{Alice\}\;
+		name: str{Bob\}\;
+		\;\}
+	values: f64*{1\;2\;3\;\}
+\})"};
+}
+
+TESTCASE(anon_projection_load)
+{
+	anon::projection const paths{"settings.network.port", "users.name", "values", "missing.path"};
+
+	buffer buff{test_data};
+	auto const result = anon::load(buff, paths);
+	EXPECT_EQ(std::size(result), 3);
+	EXPECT_EQ(std::get<uint32_t>(
+		std::get<anon::object>(std::get<anon::object>(result["settings"])["network"])["port"]), 8080);
+	auto const& users = std::get<std::vector<anon::object>>(result["users"]);
+	REQUIRE_EQ(std::size(users), 3);
+	EXPECT_EQ(std::size(users[0]), 1);
+	EXPECT_EQ(std::get<std::string>(users[1]["name"]), "Bob");
+	EXPECT_EQ(std::size(users[2]), 0);
+	EXPECT_EQ(std::size(std::get<std::vector<double>>(result["values"])), 3);
+
+	buffer expected_buff{expected};
+	EXPECT_EQ(anon::to_string(result), anon::to_string(anon::load(expected_buff)));
+
+	for(size_t chunk_size : {1, 7, 4096})
+	{
+		chunked_buffer buff{test_data, chunk_size};
+		EXPECT_EQ(anon::to_string(anon::load(buff, paths)), anon::to_string(result));
+	}
+}
+
+TESTCASE(anon_projection_select_subtree)
+{
+	buffer all{test_data};
+	auto const reference = anon::load(all);
+
+	anon::projection const paths{"settings.network.port", "settings"};
+	buffer buff{test_data};
+	auto const result = anon::load(buff, paths);
+	REQUIRE_EQ(std::size(result), 1);
+	EXPECT_EQ(anon::to_string(std::get<anon::object>(result["settings"])),
+		anon::to_string(std::get<anon::object>(reference["settings"])));
+
+	anon::projection const nothing{};
+	buffer buff2{test_data};
+	EXPECT_EQ(std::size(anon::load(buff2, nothing)), 0);
+}
+
+TESTCASE(anon_projection_skip_incomplete)
+{
+	anon::projection const paths{"a"};
+	for(auto const src : {R"(obj{b: obj{c: str{x\})", R"(obj{b: str{x\}a: i32{1\})", R"(obj{b: foo{\}\})"})
+	{
+		try
+		{
+			buffer buff{src};
+			(void)anon::load(buff, paths);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+
+	try
+	{
+		(void)anon::projection{"a..b"};
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+}
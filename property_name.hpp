@@ -8,7 +8,13 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 
 /**
@@ -55,16 +61,38 @@ namespace anon
 		});
 	}
 
+	/**
+	 * \brief Computes the hash value used by property_name
+	 *
+	 * \ingroup property_names
+	 */
+	constexpr uint32_t property_name_hash(std::string_view str)
+	{
+		// 32-bit FNV-1a
+		uint32_t ret = 2166136261u;
+		for(auto item : str)
+		{
+			ret ^= static_cast<uint8_t>(item);
+			ret *= 16777619u;
+		}
+		return ret;
+	}
+
 	/**
 	 * \brief Storage class for a Property name
 	 *
+	 * Since a property name is shorter than 32 characters, it is stored inline in a 32-byte buffer,
+	 * padded with zeros. The length and a hash value are computed when the property name is
+	 * created. Two property names are compared as four 64-bit words, which gives the same result as
+	 * comparing the strings character by character.
+	 *
 	 * \ingroup property_names
 	 *
 	 */
 	class property_name
 	{
 	public:
-		property_name() = default;
+		constexpr property_name() = default;
 
 		/**
 		 * \brief Sets a property name from src
@@ -73,54 +101,134 @@ namespace anon
 		 * src cannot be used as a property name, it throws an exception
 		 *
 		 */
-		explicit property_name(std::string_view src)
+		constexpr explicit property_name(std::string_view src):
+			m_hash{property_name_hash(src)},
+			m_size{static_cast<uint8_t>(std::size(src))}
 		{
 			if(!is_valid_property_name(src))
 			{throw std::runtime_error{std::string{"Malformed property name '"}.append(src).append("'")};}
 
-			m_val = src;
+			std::ranges::copy(src, std::begin(m_data));
 		}
 
 		/**
 		 * \brief Returns a pointer to a c string, containing the property name
 		 */
-		char const* c_str() const
-		{ return m_val.c_str(); }
+		constexpr char const* c_str() const
+		{ return std::data(m_data); }
 
 		/**
 		 * \brief Returns an iterator to the first element of the property name
 		 */
-		auto begin() const
-		{ return std::begin(m_val); }
+		constexpr auto begin() const
+		{ return std::data(m_data); }
 
 		/**
 		 * \brief Returns an iterator to the last element after the last of the property name
 		 */
-		auto end() const
-		{ return std::end(m_val); }
+		constexpr auto end() const
+		{ return std::data(m_data) + m_size; }
 
 		/**
 		 * \brief Returns the number of characters in the property name
 		 */
-		auto size() const
-		{ return std::size(m_val); }
+		constexpr size_t size() const
+		{ return m_size; }
 
 		/**
-		 * \brief Default comparison operator
+		 * \brief Returns the hash value of the property name
 		 */
-		auto operator<=>(property_name const&) const = default;
+		constexpr uint32_t hash() const
+		{ return m_hash; }
+
+		/**
+		 * \brief Compares two property names
+		 */
+		constexpr std::strong_ordering operator<=>(property_name const& other) const
+		{
+			auto const a = words();
+			auto const b = other.words();
+			for(size_t k = 0; k != std::size(a); ++k)
+			{
+				if(a[k] != b[k])
+				{ return a[k] <=> b[k]; }
+			}
+			return std::strong_ordering::equal;
+		}
+
+		/**
+		 * \brief Checks whether or not two property names are equal
+		 */
+		constexpr bool operator==(property_name const& other) const
+		{
+			return m_hash == other.m_hash
+				&& std::bit_cast<word_array>(m_data) == std::bit_cast<word_array>(other.m_data);
+		}
 
 		/**
 		 * \brief Converts the property name into a std::string_view
 		 */
-		operator std::string_view() const
+		constexpr operator std::string_view() const
 		{
-			return static_cast<std::string_view>(m_val);
+			return std::string_view{std::data(m_data), m_size};
 		}
 
 	private:
-		std::string m_val;
+		using word_array = std::array<uint64_t, 4>;
+
+		alignas(8) std::array<char, 32> m_data{};
+		uint32_t m_hash{property_name_hash("")};
+		uint8_t m_size{0};
+
+		// Returns the words of m_data, in an order such that comparing them as integers gives the
+		// same result as comparing the characters
+		constexpr word_array words() const
+		{
+			auto ret = std::bit_cast<word_array>(m_data);
+			if constexpr(std::endian::native == std::endian::little)
+			{
+				for(auto& item : ret)
+				{ item = __builtin_bswap64(item); }
+			}
+			return ret;
+		}
 	};
+
+	namespace property_name_detail
+	{
+		template<size_t N>
+		struct string_literal
+		{
+			constexpr string_literal(char const (&str)[N])
+			{ std::copy_n(str, N, value); }
+
+			char value[N];
+		};
+	}
+
+	namespace literals
+	{
+		/**
+		 * \brief Creates a property_name from a string literal
+		 *
+		 * The property name is validated at compile time, so a malformed property name results in a
+		 * compilation error.
+		 *
+		 * \ingroup property_names
+		 */
+		template<property_name_detail::string_literal Str>
+		consteval property_name operator""_pn()
+		{
+			return property_name{std::string_view{Str.value, std::size(Str.value) - 1}};
+		}
+	}
 }
 
+template<>
+struct std::hash<anon::property_name>
+{
+	size_t operator()(anon::property_name const& name) const
+	{ return name.hash(); }
+};
+
 #endif
\ No newline at end of file
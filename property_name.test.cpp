@@ -0,0 +1,62 @@
+//@	{"target":{"name":"property_name.test"}}
+
+#include "./property_name.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <vector>
+
+using namespace anon::literals;
+
+static_assert(sizeof(anon::property_name) == 40);
+static_assert(alignof(anon::property_name) == 8);
+static_assert("foo"_pn == anon::property_name{"foo"});
+static_assert("foo"_pn.hash() == anon::property_name_hash("foo"));
+static_assert("bar"_pn < "foo"_pn);
+
+TESTCASE(anon_property_name_create)
+{
+	anon::property_name name{"foobar"};
+	EXPECT_EQ(std::size(name), 6);
+	EXPECT_EQ(std::string_view{name}, "foobar");
+	EXPECT_EQ(std::string_view{name.c_str()}, "foobar");
+	EXPECT_EQ(std::string(std::begin(name), std::end(name)), "foobar");
+	EXPECT_EQ(name.hash(), anon::property_name_hash("foobar"));
+
+	anon::property_name longest{"abcdefghijklmnopqrstuvwxyz01234"};
+	EXPECT_EQ(std::size(longest), 31);
+	EXPECT_EQ(std::string_view{longest.c_str()}, "abcdefghijklmnopqrstuvwxyz01234");
+
+	EXPECT_EQ(anon::property_name{}, anon::property_name{""});
+}
+
+TESTCASE(anon_property_name_malformed)
+{
+	for(auto const str : {"Foo", "__foo", "1foo", "foo bar", "abcdefghijklmnopqrstuvwxyz012345"})
+	{
+		try
+		{
+			anon::property_name name{str};
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+}
+
+TESTCASE(anon_property_name_compare)
+{
+	std::vector<std::string_view> const names{"", "a", "a_", "a0", "aa", "ab", "abcdefgh",
+		"abcdefgh_", "abcdefgha", "abcdefghijklmnopqrstuvwxyz01234", "abcdefghijklmnopqrstuvwxyz0124",
+		"b", "z"};
+
+	for(auto a : names)
+	{
+		for(auto b : names)
+		{
+			EXPECT_EQ((anon::property_name{a} <=> anon::property_name{b}), (a <=> b));
+			EXPECT_EQ((anon::property_name{a} == anon::property_name{b}), (a == b));
+			EXPECT_EQ((anon::property_name{a} < b), (a < b));
+		}
+	}
+}
@@ -0,0 +1,73 @@
+//@	{"target":{"name":"reactor.o"}}
+
+#include "./reactor.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace
+{
+	[[noreturn]] void throw_error(char const* msg)
+	{
+		throw std::runtime_error{std::string{msg}.append(strerror(errno))};
+	}
+}
+
+anon::reactor_detail::epoll_fd::epoll_fd():m_fd{::epoll_create1(EPOLL_CLOEXEC)}
+{
+	if(m_fd == -1)
+	{ throw_error("Failed to create epoll instance: "); }
+}
+
+anon::reactor_detail::epoll_fd::~epoll_fd()
+{
+	::close(m_fd);
+}
+
+void anon::reactor_detail::epoll_fd::add(int fd)
+{
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.fd = fd;
+	if(::epoll_ctl(m_fd, EPOLL_CTL_ADD, fd, &event) == -1)
+	{ throw_error("Failed to watch file descriptor: "); }
+}
+
+void anon::reactor_detail::epoll_fd::add_oneshot(int fd)
+{
+	epoll_event event{};
+	event.events = EPOLLIN | EPOLLONESHOT;
+	event.data.fd = fd;
+	if(::epoll_ctl(m_fd, EPOLL_CTL_MOD, fd, &event) == 0)
+	{ return; }
+
+	if(errno != ENOENT || ::epoll_ctl(m_fd, EPOLL_CTL_ADD, fd, &event) == -1)
+	{ throw_error("Failed to watch file descriptor: "); }
+}
+
+void anon::reactor_detail::epoll_fd::remove(int fd)
+{
+	::epoll_ctl(m_fd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+size_t anon::reactor_detail::epoll_fd::wait(std::span<int> fds, int timeout)
+{
+	std::array<epoll_event, 64> events;
+	auto const n = ::epoll_wait(m_fd, std::data(events),
+		static_cast<int>(std::min(std::size(fds), std::size(events))), timeout);
+	if(n == -1)
+	{
+		if(errno == EINTR)
+		{ return 0; }
+		throw_error("Failed to wait for events: ");
+	}
+
+	for(int k = 0; k != n; ++k)
+	{ fds[static_cast<size_t>(k)] = events[static_cast<size_t>(k)].data.fd; }
+	return static_cast<size_t>(n);
+}
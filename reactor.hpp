@@ -0,0 +1,358 @@
+//@	{"dependencies_extra":[{"ref":"./reactor.o","rel":"implementation"}]}
+
+#ifndef ANON_REACTOR_HPP
+#define ANON_REACTOR_HPP
+
+/**
+ * \file reactor.hpp
+ *
+ * \brief Contains the definition of reactor, which reads values from many file descriptors on a
+ * single thread
+ */
+
+#include "./fd_source.hpp"
+#include "./record_reader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace anon
+{
+	/**
+	 * \brief Defines the requirements of a handler for the events reported by a reactor
+	 *
+	 * ```
+	 * void on_value(int fd, Object&& value);      // A complete value was read from fd
+	 * void on_close(int fd);                      // fd reached end of stream between two values
+	 * void on_error(int fd, std::exception_ptr);  // Reading from fd failed
+	 * ```
+	 *
+	 * Before on_close or on_error is called, fd has already been removed from the reactor.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class T, class Object>
+	concept stream_handler = requires(T a, int fd, Object&& value, std::exception_ptr error)
+	{
+		{ a.on_value(fd, std::move(value)) };
+		{ a.on_close(fd) };
+		{ a.on_error(fd, error) };
+	};
+
+	namespace reactor_detail
+	{
+		/**
+		 * \brief Owns an epoll instance
+		 */
+		class epoll_fd
+		{
+		public:
+			epoll_fd();
+
+			epoll_fd(epoll_fd const&) = delete;
+			epoll_fd& operator=(epoll_fd const&) = delete;
+
+			~epoll_fd();
+
+			/**
+			 * \brief Starts watching fd for incoming data
+			 */
+			void add(int fd);
+
+			/**
+			 * \brief Watches fd until it becomes readable once. After that, fd must be watched again
+			 * to get another notification.
+			 */
+			void add_oneshot(int fd);
+
+			/**
+			 * \brief Stops watching fd
+			 */
+			void remove(int fd);
+
+			/**
+			 * \brief Waits at most timeout milliseconds for any file descriptor to become readable,
+			 * and stores the readable file descriptors in fds
+			 *
+			 * \return The number of file descriptors stored in fds
+			 */
+			size_t wait(std::span<int> fds, int timeout);
+
+		private:
+			int m_fd;
+		};
+	}
+
+	/**
+	 * \brief Reads values from many non-blocking file descriptors, using epoll
+	 *
+	 * Each file descriptor gets its own record_reader, so partially received values are kept until
+	 * more data arrives. Whenever a complete value has been read, it is passed to the handler.
+	 *
+	 * To keep a single busy file descriptor from starving the others, at most
+	 * max_values_per_wakeup values are read from each file descriptor per call to run_once. Any
+	 * remaining values are read during the next call.
+	 *
+	 * Exceptions thrown by the handler are propagated to the caller of run_once. The file
+	 * descriptor is kept, and the value that the handler failed to process is lost.
+	 *
+	 * \note File descriptors are not owned by the reactor, and must be closed by the caller, after
+	 * they have been removed
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<class Handler, class Object = object>
+	requires(stream_handler<std::remove_reference_t<Handler>, Object>)
+	class reactor
+	{
+	public:
+		explicit reactor(Handler&& handler, size_t max_values_per_wakeup = 64):
+			m_handler{std::forward<Handler>(handler)},
+			m_max_values_per_wakeup{max_values_per_wakeup}
+		{}
+
+		/**
+		 * \brief Puts fd in non-blocking mode, and starts reading values from it
+		 */
+		void add(int fd)
+		{
+			make_non_blocking(fd);
+			auto reader = std::make_unique<reader_type>(fd_source{fd});
+			m_epoll.add(fd);
+			m_streams.insert_or_assign(fd, std::move(reader));
+		}
+
+		/**
+		 * \brief Stops reading values from fd. Any partially received value is discarded.
+		 */
+		void remove(int fd)
+		{
+			if(m_streams.erase(fd) != 0)
+			{ m_epoll.remove(fd); }
+		}
+
+		/**
+		 * \brief Returns the number of file descriptors that are currently being read
+		 */
+		size_t size() const
+		{ return std::size(m_streams); }
+
+		/**
+		 * \brief Waits at most timeout milliseconds for data, and reads the values that can be read
+		 * without blocking
+		 *
+		 * A negative timeout means waiting indefinitely. If values were left unread by the previous
+		 * call, there is no waiting.
+		 *
+		 * \return The number of values passed to the handler
+		 */
+		size_t run_once(int timeout = -1)
+		{
+			// Values that have already been received are not reported by epoll, so file
+			// descriptors that were cut off last time are serviced without waiting
+			auto const cut_off = std::exchange(m_cut_off, std::vector<int>{});
+			std::array<int, 64> fds;
+			auto const n = m_epoll.wait(fds, std::size(cut_off) != 0? 0 : timeout);
+			size_t ret = 0;
+			try
+			{
+				for(auto fd : cut_off)
+				{ ret += service(fd); }
+
+				for(size_t k = 0; k != n; ++k)
+				{
+					if(std::ranges::find(cut_off, fds[k]) == std::end(cut_off))
+					{ ret += service(fds[k]); }
+				}
+			}
+			catch(...)
+			{
+				// The handler failed. Make sure that values that have already been received are
+				// not forgotten.
+				for(auto fd : cut_off)
+				{
+					if(std::ranges::find(m_cut_off, fd) == std::end(m_cut_off))
+					{ m_cut_off.push_back(fd); }
+				}
+				throw;
+			}
+			return ret;
+		}
+
+		/**
+		 * \brief Calls run_once until all file descriptors have been removed
+		 */
+		void run()
+		{
+			while(size() != 0)
+			{ run_once(); }
+		}
+
+		decltype(auto) handler()
+		{ return (m_handler); }
+
+		decltype(auto) handler() const
+		{ return (m_handler); }
+
+	private:
+		using reader_type = record_reader<fd_source, Object>;
+
+		reactor_detail::epoll_fd m_epoll;
+		std::unordered_map<int, std::unique_ptr<reader_type>> m_streams;
+		std::vector<int> m_cut_off;
+		Handler m_handler;
+		size_t m_max_values_per_wakeup;
+
+		size_t service(int fd)
+		{
+			size_t ret = 0;
+			auto i = m_streams.find(fd);
+			if(i == std::end(m_streams))
+			{ return ret; }
+
+			auto const reader = i->second.get();
+			while(ret != m_max_values_per_wakeup)
+			{
+				stream_status status;
+				try
+				{ status = reader->read_next(); }
+				catch(...)
+				{
+					remove(fd);
+					m_handler.on_error(fd, std::current_exception());
+					return ret;
+				}
+
+				switch(status)
+				{
+					case stream_status::ready:
+						++ret;
+						try
+						{ m_handler.on_value(fd, std::move(reader->current())); }
+						catch(...)
+						{
+							// More values may already have been received from fd
+							m_cut_off.push_back(fd);
+							throw;
+						}
+						// The handler may have removed fd
+						if(i = m_streams.find(fd); i == std::end(m_streams) || i->second.get() != reader)
+						{ return ret; }
+						break;
+
+					case stream_status::eof:
+						remove(fd);
+						m_handler.on_close(fd);
+						return ret;
+
+					case stream_status::blocking:
+						return ret;
+				}
+			}
+
+			m_cut_off.push_back(fd);
+			return ret;
+		}
+	};
+
+	template<class Handler>
+	reactor(Handler&) -> reactor<Handler&>;
+
+	template<class Handler>
+	reactor(Handler&, size_t) -> reactor<Handler&>;
+
+	/**
+	 * \brief An executor for async_load and async_record_reader, that uses epoll to find out when
+	 * an fd_source has more data
+	 *
+	 * Coroutines that wait for data are resumed from run_once, on the thread that calls it. Only one
+	 * coroutine at a time may wait for a given file descriptor.
+	 *
+	 * \ingroup de-serialization
+	 */
+	class epoll_executor
+	{
+	public:
+		/**
+		 * \brief Resumes handle from run_once, after the file descriptor of src has become readable
+		 *
+		 * \note If another coroutine is already waiting for the same file descriptor, an exception
+		 * is thrown
+		 */
+		void resume_when_readable(fd_source& src, std::coroutine_handle<> handle)
+		{
+			auto const i = m_waiting.try_emplace(src.fd(), handle);
+			if(!i.second)
+			{ throw std::runtime_error{"Another coroutine is already waiting for this file descriptor"}; }
+
+			try
+			{ m_epoll.add_oneshot(src.fd()); }
+			catch(...)
+			{
+				m_waiting.erase(i.first);
+				throw;
+			}
+		}
+
+		/**
+		 * \brief Forgets handle, which is waiting for src, without resuming it
+		 *
+		 * This is called when a coroutine is destroyed while it is waiting for data.
+		 */
+		void cancel(fd_source& src, std::coroutine_handle<> handle)
+		{
+			if(auto i = m_waiting.find(src.fd()); i != std::end(m_waiting) && i->second == handle)
+			{
+				m_waiting.erase(i);
+				m_epoll.remove(src.fd());
+			}
+		}
+
+		/**
+		 * \brief Waits at most timeout milliseconds for data, and resumes the coroutines that
+		 * waited for it
+		 *
+		 * A negative timeout means waiting indefinitely.
+		 *
+		 * \return The number of coroutines that were resumed
+		 */
+		size_t run_once(int timeout = -1)
+		{
+			std::array<int, 64> fds;
+			auto const n = m_epoll.wait(fds, timeout);
+			size_t ret = 0;
+			for(size_t k = 0; k != n; ++k)
+			{
+				auto i = m_waiting.find(fds[k]);
+				if(i == std::end(m_waiting))
+				{ continue; }
+
+				auto const handle = i->second;
+				m_waiting.erase(i);
+				handle.resume();
+				++ret;
+			}
+			return ret;
+		}
+
+		/**
+		 * \brief Returns the number of coroutines that are waiting for data
+		 */
+		size_t size() const
+		{ return std::size(m_waiting); }
+
+	private:
+		reactor_detail::epoll_fd m_epoll;
+		std::unordered_map<int, std::coroutine_handle<>> m_waiting;
+	};
+}
+
+#endif
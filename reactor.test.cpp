@@ -0,0 +1,287 @@
+//@	{"target":{"name":"reactor.test"}}
+
+#include "./reactor.hpp"
+#include "./coroutine.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+	struct collector
+	{
+		std::map<int, std::vector<anon::object>> values;
+		std::vector<int> closed;
+		std::vector<int> failed;
+
+		void on_value(int fd, anon::object&& value)
+		{ values[fd].push_back(std::move(value)); }
+
+		void on_close(int fd)
+		{ closed.push_back(fd); }
+
+		void on_error(int fd, std::exception_ptr)
+		{ failed.push_back(fd); }
+	};
+
+	static_assert(anon::stream_handler<collector, anon::object>);
+
+	void write_all(int fd, std::string_view data)
+	{
+		while(std::size(data) != 0)
+		{
+			auto const n = ::write(fd, std::data(data), std::size(data));
+			if(n <= 0)
+			{ throw std::runtime_error{"Write failed"}; }
+			data.remove_prefix(static_cast<size_t>(n));
+		}
+	}
+}
+
+TESTCASE(anon_reactor_many_streams)
+{
+	constexpr size_t num_streams = 50;
+	std::vector<std::array<int, 2>> pipes(num_streams);
+	collector handler;
+	anon::reactor reactor{handler};
+	for(auto& item : pipes)
+	{
+		REQUIRE_EQ(::pipe(std::data(item)), 0);
+		reactor.add(item[0]);
+	}
+	EXPECT_EQ(reactor.size(), num_streams);
+
+	// Write every record in two parts, so that each part arrives separately
+	for(size_t record = 0; record != 3; ++record)
+	{
+		for(size_t k = 0; k != num_streams; ++k)
+		{
+			write_all(pipes[k][1], std::string{"obj{stream: u64{"}.append(std::to_string(k)));
+		}
+		EXPECT_EQ(reactor.run_once(0), 0);
+
+		for(size_t k = 0; k != num_streams; ++k)
+		{
+			write_all(pipes[k][1], std::string{"\\} record: u64{"}.append(std::to_string(record))
+				.append("\\}\\}\n"));
+		}
+
+		size_t values = 0;
+		while(values != num_streams)
+		{ values += reactor.run_once(1000); }
+	}
+
+	for(auto& item : pipes)
+	{ ::close(item[1]); }
+	reactor.run();
+	EXPECT_EQ(reactor.size(), 0);
+	EXPECT_EQ(std::size(handler.closed), num_streams);
+	EXPECT_EQ(std::size(handler.failed), 0);
+
+	for(size_t k = 0; k != num_streams; ++k)
+	{
+		auto const& values = handler.values[pipes[k][0]];
+		REQUIRE_EQ(std::size(values), 3);
+		for(size_t record = 0; record != 3; ++record)
+		{
+			auto const& value = values[record];
+			EXPECT_EQ(std::get<uint64_t>(value.find(anon::property_name{"stream"})->second), k);
+			EXPECT_EQ(std::get<uint64_t>(value.find(anon::property_name{"record"})->second), record);
+		}
+	}
+
+	for(auto& item : pipes)
+	{ ::close(item[0]); }
+}
+
+TESTCASE(anon_reactor_errors)
+{
+	int good[2];
+	int bad[2];
+	int truncated[2];
+	REQUIRE_EQ(::pipe(good), 0);
+	REQUIRE_EQ(::pipe(bad), 0);
+	REQUIRE_EQ(::pipe(truncated), 0);
+
+	anon::reactor reactor{collector{}};
+	reactor.add(good[0]);
+	reactor.add(bad[0]);
+	reactor.add(truncated[0]);
+
+	write_all(good[1], R"(obj{a: i32{1\}\})");
+	write_all(bad[1], R"(obj{a: foo{1\}\})");
+	write_all(truncated[1], R"(obj{a: i32{1\})");
+	::close(truncated[1]);
+
+	while(std::size(reactor.handler().failed) != 2)
+	{ reactor.run_once(1000); }
+
+	EXPECT_EQ(reactor.size(), 1);
+	EXPECT_EQ(std::size(reactor.handler().values[good[0]]), 1);
+	EXPECT_EQ(std::size(reactor.handler().closed), 0);
+
+	reactor.remove(good[0]);
+	EXPECT_EQ(reactor.size(), 0);
+
+	for(auto fd : {good[0], good[1], bad[0], bad[1], truncated[0]})
+	{ ::close(fd); }
+}
+
+TESTCASE(anon_reactor_fairness)
+{
+	int busy[2];
+	int quiet[2];
+	REQUIRE_EQ(::pipe(busy), 0);
+	REQUIRE_EQ(::pipe(quiet), 0);
+
+	collector handler;
+	anon::reactor reactor{handler, 16};
+	reactor.add(busy[0]);
+	reactor.add(quiet[0]);
+
+	std::string records;
+	for(size_t k = 0; k != 100; ++k)
+	{ records.append(R"(obj{a: i32{1\}\})"); }
+	write_all(busy[1], records);
+	write_all(quiet[1], R"(obj{a: i32{2\}\})");
+
+	// All data from busy may have been consumed by its record_reader, so the remaining values
+	// must be read without any new data arriving
+	EXPECT_EQ(reactor.run_once(1000), 17);
+	EXPECT_EQ(std::size(handler.values[busy[0]]), 16);
+	EXPECT_EQ(std::size(handler.values[quiet[0]]), 1);
+
+	for(size_t k = 0; k != 10 && std::size(handler.values[busy[0]]) != 100; ++k)
+	{ reactor.run_once(1000); }
+	EXPECT_EQ(std::size(handler.values[busy[0]]), 100);
+
+	for(auto fd : {busy[0], busy[1], quiet[0], quiet[1]})
+	{ ::close(fd); }
+}
+
+namespace
+{
+	struct throwing_handler
+	{
+		size_t values{0};
+		size_t errors{0};
+
+		void on_value(int, anon::object&&)
+		{
+			++values;
+			throw std::runtime_error{"Handler failed"};
+		}
+
+		void on_close(int)
+		{}
+
+		void on_error(int, std::exception_ptr)
+		{ ++errors; }
+	};
+}
+
+TESTCASE(anon_reactor_handler_exception)
+{
+	int fds[2];
+	REQUIRE_EQ(::pipe(fds), 0);
+
+	anon::reactor reactor{throwing_handler{}};
+	reactor.add(fds[0]);
+	write_all(fds[1], R"(obj{a: i32{1\}\} obj{a: i32{2\}\})");
+
+	for(size_t k = 0; k != 2; ++k)
+	{
+		try
+		{
+			reactor.run_once(1000);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+
+	EXPECT_EQ(reactor.handler().values, 2);
+	EXPECT_EQ(reactor.handler().errors, 0);
+	EXPECT_EQ(reactor.size(), 1);
+
+	for(auto fd : {fds[0], fds[1]})
+	{ ::close(fd); }
+}
+
+namespace
+{
+	anon::task<size_t> count_records(int fd, anon::epoll_executor& exec)
+	{
+		anon::async_record_reader reader{anon::fd_source{fd}, exec};
+		size_t ret = 0;
+		while(co_await reader.next() != nullptr)
+		{ ++ret; }
+		co_return ret;
+	}
+}
+
+TESTCASE(anon_epoll_executor)
+{
+	int fds[2];
+	REQUIRE_EQ(::pipe(fds), 0);
+	anon::make_non_blocking(fds[0]);
+
+	anon::epoll_executor exec;
+	auto task = count_records(fds[0], exec);
+	task.start();
+	EXPECT_EQ(exec.size(), 1);
+	EXPECT_EQ(exec.run_once(0), 0);
+
+	write_all(fds[1], R"(obj{a: i32{1\}\} obj{a: i32{2\})");
+	EXPECT_EQ(exec.run_once(1000), 1);
+	EXPECT_EQ(task.done(), false);
+
+	write_all(fds[1], R"(\})");
+	::close(fds[1]);
+	while(!task.done())
+	{ exec.run_once(1000); }
+
+	EXPECT_EQ(task.result(), 2);
+	EXPECT_EQ(exec.size(), 0);
+	::close(fds[0]);
+}
+
+TESTCASE(anon_epoll_executor_waiters)
+{
+	int fds[2];
+	REQUIRE_EQ(::pipe(fds), 0);
+	anon::make_non_blocking(fds[0]);
+
+	anon::epoll_executor exec;
+	{
+		auto task = count_records(fds[0], exec);
+		task.start();
+		EXPECT_EQ(exec.size(), 1);
+
+		// Only one coroutine may wait for a file descriptor
+		auto other = count_records(fds[0], exec);
+		other.start();
+		EXPECT_EQ(other.done(), true);
+		try
+		{
+			(void)other.result();
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+		EXPECT_EQ(exec.size(), 1);
+	}
+
+	// The task was destroyed while waiting, so it must not be resumed
+	EXPECT_EQ(exec.size(), 0);
+	write_all(fds[1], R"(obj{a: i32{1\}\})");
+	EXPECT_EQ(exec.run_once(0), 0);
+
+	for(auto fd : {fds[0], fds[1]})
+	{ ::close(fd); }
+}
@@ -0,0 +1,249 @@
+#ifndef ANON_RECORDREADER_HPP
+#define ANON_RECORDREADER_HPP
+
+/**
+ * \file record_reader.hpp
+ *
+ * \brief Contains the definition of record_reader
+ */
+
+#include "./object.hpp"
+#include "./event_parser.hpp"
+#include "./dom_builder.hpp"
+#include "./source.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+
+namespace anon
+{
+	/**
+	 * \brief Counters collected by a record_reader
+	 *
+	 * \ingroup de-serialization
+	 */
+	struct record_reader_stats
+	{
+		/**
+		 * \brief The number of records that have been read
+		 */
+		size_t records{0};
+
+		/**
+		 * \brief The number of bytes that have been consumed by the parser
+		 */
+		size_t bytes{0};
+
+		/**
+		 * \brief The number of reads from the source that returned data
+		 *
+		 * For a chunked_source, this is the number of chunks, which tells how well the source
+		 * fills its buffer. A source that is read by read_byte returns one byte per read, so for
+		 * such a source, this is the same as bytes.
+		 */
+		size_t reads{0};
+
+		/**
+		 * \brief The number of reads from the source that would have blocked
+		 */
+		size_t blocked_reads{0};
+	};
+
+	/**
+	 * \brief Reads a stream of concatenated records, each being an Object
+	 *
+	 * Unlike async_loader, a record_reader keeps the same parser for the entire stream, so all
+	 * scratch storage in the parser is reused between records. Also, the storage of the current
+	 * record is reused by the next record, unless it has been moved out of the reader. Reaching the
+	 * end of the stream between two records is not an error.
+	 *
+	 * A record_reader is also an input range of records, that blocks if the source would block.
+	 *
+	 * \ingroup de-serialization
+	 */
+	template<source Source, class Object = object>
+	class record_reader
+	{
+	public:
+		explicit record_reader(Source&& src, typename Object::allocator_type const& alloc = {}):
+			m_source{std::forward<Source>(src)},
+			m_parser{dom_builder<Object>{alloc}},
+			m_current{alloc}
+		{}
+
+		/**
+		 * \brief Tries to read the next record
+		 *
+		 * \return stream_status::ready if a record was read, and can be accessed through current.
+		 * stream_status::eof if the stream ended between two records. stream_status::blocking if
+		 * no more data can be read without blocking.
+		 *
+		 * \note If the stream ends within a record, an exception is thrown
+		 */
+		stream_status read_next()
+		{
+			if(m_has_current)
+			{
+				m_parser.handler().recycle(std::move(m_current));
+				m_has_current = false;
+			}
+
+			if constexpr(chunked_source<Source>)
+			{
+				while(true)
+				{
+					if(std::size(m_pending) == 0)
+					{
+						auto const read_res = read_chunk(m_source);
+						if(read_res.status != stream_status::ready)
+						{ return end_of_data(read_res.status); }
+
+						++m_stats.reads;
+						m_pending = read_res.data;
+					}
+
+					auto const res = m_parser.update(m_pending);
+					m_pending = m_pending.subspan(res.bytes_consumed);
+					m_stats.bytes += res.bytes_consumed;
+					if(res.status == parse_result::done)
+					{ return take_record(); }
+				}
+			}
+			else
+			{
+				while(true)
+				{
+					auto const read_res = read_byte(m_source);
+					if(read_res.status != stream_status::ready)
+					{ return end_of_data(read_res.status); }
+
+					++m_stats.reads;
+					++m_stats.bytes;
+					if(m_parser.update(read_res.value) == parse_result::done)
+					{ return take_record(); }
+				}
+			}
+		}
+
+		/**
+		 * \brief Returns the most recently read record
+		 *
+		 * \note The record may be moved out of the reader. Otherwise, its storage is reused by the
+		 * next record, which means that the record is only valid until the next call to read_next.
+		 */
+		Object& current()
+		{ return m_current; }
+
+		/**
+		 * \brief Returns the counters collected so far
+		 */
+		record_reader_stats const& stats() const
+		{ return m_stats; }
+
+		decltype(auto) source()
+		{ return (m_source); }
+
+		class iterator
+		{
+		public:
+			using value_type = Object;
+			using difference_type = std::ptrdiff_t;
+
+			iterator():m_reader{nullptr}
+			{}
+
+			explicit iterator(record_reader& reader):m_reader{&reader}
+			{ read(); }
+
+			Object& operator*() const
+			{ return m_reader->current(); }
+
+			Object* operator->() const
+			{ return &m_reader->current(); }
+
+			iterator& operator++()
+			{
+				read();
+				return *this;
+			}
+
+			void operator++(int)
+			{ ++*this; }
+
+			bool operator==(std::default_sentinel_t) const
+			{ return m_reader == nullptr; }
+
+		private:
+			record_reader* m_reader;
+
+			void read()
+			{
+				while(true)
+				{
+					switch(m_reader->read_next())
+					{
+						case stream_status::ready:
+							return;
+
+						case stream_status::eof:
+							m_reader = nullptr;
+							return;
+
+						case stream_status::blocking:
+							break;
+					}
+				}
+			}
+		};
+
+		/**
+		 * \brief Reads the first record, and returns an iterator referring to it
+		 */
+		iterator begin()
+		{ return iterator{*this}; }
+
+		std::default_sentinel_t end() const
+		{ return std::default_sentinel; }
+
+	private:
+		Source m_source;
+		event_parser<dom_builder<Object>> m_parser;
+		Object m_current;
+		bool m_has_current{false};
+		std::span<char const> m_pending;
+		record_reader_stats m_stats;
+
+		stream_status end_of_data(stream_status status)
+		{
+			if(status == stream_status::blocking)
+			{
+				++m_stats.blocked_reads;
+				return status;
+			}
+
+			if(!m_parser.idle())
+			{ throw std::runtime_error{"Empty or incomplete value"}; }
+			return status;
+		}
+
+		stream_status take_record()
+		{
+			auto result = m_parser.handler().take_result();
+			auto const record = std::get_if<Object>(&result);
+			if(record == nullptr)
+			{ throw std::runtime_error{"Record is not an object"}; }
+
+			m_current = std::move(*record);
+			m_has_current = true;
+			++m_stats.records;
+			return stream_status::ready;
+		}
+	};
+
+	template<source Source>
+	record_reader(Source&) -> record_reader<Source&>;
+}
+
+#endif
@@ -0,0 +1,168 @@
+//@	{"target":{"name":"record_reader.test"}}
+
+#include "./record_reader.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <string>
+
+namespace
+{
+	struct buffer
+	{
+		explicit buffer(std::string_view sv):data{sv}, ptr{std::begin(data)}
+		{}
+
+		std::string_view data;
+		char const* ptr;
+	};
+
+	anon::read_result read_byte(buffer& buff)
+	{
+		auto ret_val = buff.ptr != std::end(buff.data)? *buff.ptr : '\0';
+		auto ret_status = buff.ptr != std::end(buff.data) ?
+			anon::stream_status::ready: anon::stream_status::eof;
+		++buff.ptr;
+
+		return anon::read_result{ret_val, ret_status};
+	}
+
+	// A chunked source that would block after each chunk
+	struct chunked_buffer
+	{
+		explicit chunked_buffer(std::string_view sv, size_t chunk_size):
+			data{sv},
+			ptr{std::begin(data)},
+			chunk_size{chunk_size}
+		{}
+
+		std::string_view data;
+		char const* ptr;
+		size_t chunk_size;
+		bool block{false};
+	};
+
+	anon::chunk_read_result read_chunk(chunked_buffer& buff)
+	{
+		buff.block = !buff.block;
+		if(!buff.block)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::blocking}; }
+
+		auto const n = std::min(buff.chunk_size, static_cast<size_t>(std::end(buff.data) - buff.ptr));
+		if(n == 0)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::eof}; }
+
+		auto const ret = std::span{buff.ptr, n};
+		buff.ptr += n;
+		return anon::chunk_read_result{ret, anon::stream_status::ready};
+	}
+
+	std::string make_records(size_t n)
+	{
+		std::string ret;
+		for(size_t k = 0; k != n; ++k)
+		{
+			ret.append("obj{id: u64{").append(std::to_string(k)).append("\\} name: str{Record ")
+				.append(std::to_string(k)).append("\\} values: i32*{1\\;2\\;3\\;\\}\\}\n");
+		}
+		return ret;
+	}
+
+	static_assert(std::input_iterator<anon::record_reader<buffer&>::iterator>);
+	static_assert(std::ranges::input_range<anon::record_reader<buffer&>>);
+}
+
+TESTCASE(anon_record_reader_range)
+{
+	auto const src = make_records(100);
+	buffer buff{src};
+	anon::record_reader reader{buff};
+
+	size_t count = 0;
+	for(auto& record : reader)
+	{
+		EXPECT_EQ(std::get<uint64_t>(record["id"]), count);
+		EXPECT_EQ(std::get<std::string>(record["name"]), std::string{"Record "}.append(std::to_string(count)));
+		EXPECT_EQ(std::size(std::get<std::vector<int32_t>>(record["values"])), 3);
+		++count;
+	}
+
+	EXPECT_EQ(count, 100);
+	EXPECT_EQ(reader.stats().records, 100);
+	EXPECT_EQ(reader.stats().bytes, std::size(src));
+	// A byte source returns one byte per read
+	EXPECT_EQ(reader.stats().reads, reader.stats().bytes);
+	EXPECT_EQ(reader.stats().blocked_reads, 0);
+}
+
+TESTCASE(anon_record_reader_blocking)
+{
+	auto const src = make_records(10);
+	for(size_t chunk_size : {1, 7, 4096})
+	{
+		chunked_buffer buff{src, chunk_size};
+		anon::record_reader reader{buff};
+
+		std::vector<anon::object> records;
+		size_t blocked = 0;
+		while(true)
+		{
+			auto const status = reader.read_next();
+			if(status == anon::stream_status::eof)
+			{ break; }
+
+			if(status == anon::stream_status::blocking)
+			{
+				++blocked;
+				continue;
+			}
+
+			records.push_back(std::move(reader.current()));
+		}
+
+		REQUIRE_EQ(std::size(records), 10);
+		EXPECT_EQ(std::get<uint64_t>(records[9]["id"]), 9);
+		EXPECT_EQ(reader.stats().records, 10);
+		EXPECT_EQ(reader.stats().bytes, std::size(src));
+		EXPECT_EQ(reader.stats().blocked_reads, blocked);
+		// A chunked source returns one chunk per read
+		EXPECT_EQ(reader.stats().reads, (std::size(src) + chunk_size - 1)/chunk_size);
+	}
+}
+
+TESTCASE(anon_record_reader_reuse)
+{
+	auto const src = make_records(10);
+	buffer buff{src};
+	anon::record_reader reader{buff};
+
+	std::vector<void const*> properties;
+	for(auto& record : reader)
+	{ properties.push_back(&*std::begin(record)); }
+
+	REQUIRE_EQ(std::size(properties), 10);
+	for(size_t k = 2; k != std::size(properties); ++k)
+	{ EXPECT_EQ(properties[k], properties[1]); }
+}
+
+TESTCASE(anon_record_reader_errors)
+{
+	for(auto const src : {R"(obj{a: i32{1\}\} obj{a: i32{1\})", R"(obj{a: i32{1\}\} obj)",
+		R"(obj{a: i32{1\}\} i32{1\})"})
+	{
+		buffer buff{src};
+		anon::record_reader reader{buff};
+		REQUIRE_EQ(reader.read_next(), anon::stream_status::ready);
+		try
+		{
+			(void)reader.read_next();
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+
+	buffer buff{" \n "};
+	anon::record_reader reader{buff};
+	EXPECT_EQ(reader.read_next(), anon::stream_status::eof);
+}
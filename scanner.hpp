@@ -0,0 +1,227 @@
+#ifndef ANON_SCANNER_HPP
+#define ANON_SCANNER_HPP
+
+/**
+ * \file scanner.hpp
+ *
+ * \brief Contains functions for quickly finding characters that are significant to the parser
+ */
+
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace anon::scanner
+{
+	/**
+	 * \brief Checks whether or not val terminates a run of characters in value mode
+	 */
+	constexpr bool is_value_delimiter(char val)
+	{
+		return val == '\\' || val == '\0';
+	}
+
+	/**
+	 * \brief Checks whether or not val terminates a run of characters in key mode
+	 */
+	constexpr bool is_key_delimiter(char val)
+	{
+		return (val >= '\0' && val <= ' ') || val == ':' || val == '\\';
+	}
+
+	/**
+	 * \brief Checks whether or not val may begin or end a value, when only the structure of a
+	 * document is of interest
+	 */
+	constexpr bool is_structure_delimiter(char val)
+	{
+		return val == '{' || val == '\\';
+	}
+
+#if defined(__SSE2__)
+	inline int value_delimiter_mask(__m128i block)
+	{
+		auto const found = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\\')),
+			_mm_cmpeq_epi8(block, _mm_setzero_si128()));
+		return _mm_movemask_epi8(found);
+	}
+
+	inline int key_delimiter_mask(__m128i block)
+	{
+		auto const is_ws = _mm_cmpeq_epi8(_mm_min_epu8(block, _mm_set1_epi8(' ')), block);
+		auto const found = _mm_or_si128(is_ws,
+			_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(':')),
+				_mm_cmpeq_epi8(block, _mm_set1_epi8('\\'))));
+		return _mm_movemask_epi8(found);
+	}
+
+	inline int structure_delimiter_mask(__m128i block)
+	{
+		auto const found = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('{')),
+			_mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+		return _mm_movemask_epi8(found);
+	}
+#endif
+
+#if defined(__AVX2__)
+	inline uint32_t value_delimiter_mask(__m256i block)
+	{
+		auto const found = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\\')),
+			_mm256_cmpeq_epi8(block, _mm256_setzero_si256()));
+		return static_cast<uint32_t>(_mm256_movemask_epi8(found));
+	}
+
+	inline uint32_t key_delimiter_mask(__m256i block)
+	{
+		auto const is_ws = _mm256_cmpeq_epi8(_mm256_min_epu8(block, _mm256_set1_epi8(' ')), block);
+		auto const found = _mm256_or_si256(is_ws,
+			_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(':')),
+				_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\\'))));
+		return static_cast<uint32_t>(_mm256_movemask_epi8(found));
+	}
+
+	inline uint32_t structure_delimiter_mask(__m256i block)
+	{
+		auto const found = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('{')),
+			_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\\')));
+		return static_cast<uint32_t>(_mm256_movemask_epi8(found));
+	}
+#endif
+
+	/**
+	 * \brief Returns a pointer to the first character in [begin, end) that satisfies
+	 * is_value_delimiter, or end if there is no such character
+	 */
+	inline char const* find_value_delimiter(char const* begin, char const* end)
+	{
+#if defined(__AVX2__)
+		while(end - begin >= 32)
+		{
+			auto const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(begin));
+			if(auto const mask = value_delimiter_mask(block); mask != 0)
+			{ return begin + std::countr_zero(mask); }
+			begin += 32;
+		}
+#endif
+#if defined(__SSE2__)
+		while(end - begin >= 16)
+		{
+			auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(begin));
+			if(auto const mask = value_delimiter_mask(block); mask != 0)
+			{ return begin + std::countr_zero(static_cast<uint32_t>(mask)); }
+			begin += 16;
+		}
+#endif
+		while(begin != end && !is_value_delimiter(*begin))
+		{ ++begin; }
+		return begin;
+	}
+
+	/**
+	 * \brief Returns a pointer to the first character in [begin, end) that satisfies
+	 * is_key_delimiter, or end if there is no such character
+	 */
+	inline char const* find_key_delimiter(char const* begin, char const* end)
+	{
+#if defined(__AVX2__)
+		while(end - begin >= 32)
+		{
+			auto const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(begin));
+			if(auto const mask = key_delimiter_mask(block); mask != 0)
+			{ return begin + std::countr_zero(mask); }
+			begin += 32;
+		}
+#endif
+#if defined(__SSE2__)
+		while(end - begin >= 16)
+		{
+			auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(begin));
+			if(auto const mask = key_delimiter_mask(block); mask != 0)
+			{ return begin + std::countr_zero(static_cast<uint32_t>(mask)); }
+			begin += 16;
+		}
+#endif
+		while(begin != end && !is_key_delimiter(*begin))
+		{ ++begin; }
+		return begin;
+	}
+
+	/**
+	 * \brief Returns a pointer to the first character in [begin, end) that satisfies
+	 * is_structure_delimiter, or end if there is no such character
+	 */
+	inline char const* find_structure_delimiter(char const* begin, char const* end)
+	{
+#if defined(__AVX2__)
+		while(end - begin >= 32)
+		{
+			auto const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(begin));
+			if(auto const mask = structure_delimiter_mask(block); mask != 0)
+			{ return begin + std::countr_zero(mask); }
+			begin += 32;
+		}
+#endif
+#if defined(__SSE2__)
+		while(end - begin >= 16)
+		{
+			auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(begin));
+			if(auto const mask = structure_delimiter_mask(block); mask != 0)
+			{ return begin + std::countr_zero(static_cast<uint32_t>(mask)); }
+			begin += 16;
+		}
+#endif
+		while(begin != end && !is_structure_delimiter(*begin))
+		{ ++begin; }
+		return begin;
+	}
+
+	/**
+	 * \brief Returns the type tag that ends at tag_end, which is where the opening `{` of a value
+	 * was found. The tag is searched for within [begin, tag_end).
+	 */
+	inline std::string_view type_tag(char const* begin, char const* tag_end)
+	{
+		auto const is_whitespace = [](char val){ return val >= '\0' && val <= ' '; };
+		while(tag_end != begin && is_whitespace(*(tag_end - 1)))
+		{ --tag_end; }
+
+		auto tag_begin = tag_end;
+		while(tag_begin != begin && !is_whitespace(*(tag_begin - 1)) && *(tag_begin - 1) != ':')
+		{ --tag_begin; }
+
+		return std::string_view{tag_begin, tag_end};
+	}
+
+	/**
+	 * \brief Returns a pointer past the `\}` that terminates the value whose contents start at ptr
+	 *
+	 * \note The value must not be an object, or an array of objects
+	 */
+	inline char const* skip_value(char const* ptr, char const* end)
+	{
+		while(true)
+		{
+			ptr = find_value_delimiter(ptr, end);
+			if(end - ptr < 2)
+			{ throw std::runtime_error{"Empty or incomplete value"}; }
+
+			if(*ptr == '\\')
+			{
+				if(ptr[1] == '}')
+				{ return ptr + 2; }
+				ptr += 2;
+			}
+			else
+			{ ++ptr; }
+		}
+	}
+}
+
+#endif
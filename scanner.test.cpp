@@ -0,0 +1,65 @@
+//@	{"target":{"name":"scanner.test"}}
+
+#include "./scanner.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <string>
+#include <algorithm>
+
+TESTCASE(anon_scanner_find_value_delimiter)
+{
+	for(size_t k = 0; k != 80; ++k)
+	{
+		std::string str(80, 'a');
+		str[k] = '\\';
+		auto const begin = std::data(str);
+		auto const end = begin + std::size(str);
+		EXPECT_EQ(anon::scanner::find_value_delimiter(begin, end), begin + k);
+		EXPECT_EQ(anon::scanner::find_value_delimiter(begin + k + 1, end), end);
+
+		str[k] = '\0';
+		EXPECT_EQ(anon::scanner::find_value_delimiter(begin, end), begin + k);
+	}
+}
+
+TESTCASE(anon_scanner_find_key_delimiter)
+{
+	for(auto delim : {' ', '\t', '\n', '\0', ':', '\\'})
+	{
+		for(size_t k = 0; k != 80; ++k)
+		{
+			std::string str(80, 'a');
+			str[k] = delim;
+			auto const begin = std::data(str);
+			auto const end = begin + std::size(str);
+			EXPECT_EQ(anon::scanner::find_key_delimiter(begin, end), begin + k);
+			EXPECT_EQ(anon::scanner::find_key_delimiter(begin + k + 1, end), end);
+		}
+	}
+}
+
+TESTCASE(anon_scanner_find_structure_delimiter)
+{
+	for(auto delim : {'{', '\\'})
+	{
+		for(size_t k = 0; k != 80; ++k)
+		{
+			std::string str(80, '}');
+			str[k] = delim;
+			auto const begin = std::data(str);
+			auto const end = begin + std::size(str);
+			EXPECT_EQ(anon::scanner::find_structure_delimiter(begin, end), begin + k);
+			EXPECT_EQ(anon::scanner::find_structure_delimiter(begin + k + 1, end), end);
+		}
+	}
+}
+
+TESTCASE(anon_scanner_find_key_delimiter_non_ascii)
+{
+	std::string str(40, static_cast<char>(0xc3));
+	auto const begin = std::data(str);
+	auto const end = begin + std::size(str);
+	EXPECT_EQ(anon::scanner::find_key_delimiter(begin, end), end);
+	EXPECT_EQ(anon::scanner::find_value_delimiter(begin, end), end);
+}
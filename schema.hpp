@@ -0,0 +1,482 @@
+#ifndef ANON_SCHEMA_HPP
+#define ANON_SCHEMA_HPP
+
+/**
+ * \file schema.hpp
+ *
+ * \brief Contains the definitions needed to bind C++ structs to objects at compile-time
+ */
+
+#include "./property_name.hpp"
+#include "./object.hpp"
+#include "./type_info.hpp"
+#include "./variant_helper.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/**
+ * \defgroup schema Schema binding
+ *
+ * \brief This module makes it possible to load and store C++ structs directly, without building
+ * an object first
+ *
+ * To bind a struct, specialize schema, and list its members together with their property names:
+ *
+ * ```
+ * struct point
+ * {
+ *     double x;
+ *     double y;
+ *     std::string label;
+ * };
+ *
+ * template<>
+ * struct anon::schema<point>
+ * {
+ *     static constexpr std::tuple members{
+ *         anon::member{"x", &point::x},
+ *         anon::member{"y", &point::y},
+ *         anon::member{"label", &point::label}
+ *     };
+ * };
+ * ```
+ *
+ * Then, `anon::load<point>(src)` reads a point directly from src, and `anon::store(pt, sink)`
+ * writes it as an `obj`. A member may be a number of any of the types supported by object,
+ * a `std::string`, another bound struct, or a `std::vector` of any of these.
+ */
+
+namespace anon
+{
+	/**
+	 * \brief Binds the property name to the data member ptr of Class
+	 *
+	 * \ingroup schema
+	 */
+	template<class Class, class Type>
+	struct member
+	{
+		constexpr member(std::string_view name, Type Class::* ptr):name{name}, ptr{ptr}
+		{}
+
+		property_name name;
+		Type Class::* ptr;
+	};
+
+	/**
+	 * \brief Describes the members of T
+	 *
+	 * A specialization must contain a static constexpr tuple `members`, of member.
+	 *
+	 * \ingroup schema
+	 */
+	template<class T>
+	struct schema;
+
+	/**
+	 * \brief Checks whether or not T has a schema
+	 *
+	 * \ingroup schema
+	 */
+	template<class T>
+	concept described = requires
+	{
+		std::tuple_size<std::remove_cvref_t<decltype(schema<T>::members)>>::value;
+	};
+
+	/**
+	 * \brief specialization of type_info for structs with a schema
+	 *
+	 * A described struct is stored as an object.
+	 *
+	 * \ingroup type_info
+	 */
+	template<described T>
+	struct type_info<T> : type_info<object>
+	{};
+
+	namespace schema_detail
+	{
+		template<class T>
+		constexpr size_t member_count = std::tuple_size_v<std::remove_cvref_t<decltype(schema<T>::members)>>;
+
+		template<size_t Index, class T>
+		constexpr auto const& get_member()
+		{ return std::get<Index>(schema<T>::members); }
+
+		template<size_t Index, class T>
+		using member_type = std::remove_cvref_t<decltype(std::declval<T&>().*(get_member<Index, T>().ptr))>;
+
+		/**
+		 * \brief The order in which the members of T are written, which is ordered by name, just like
+		 * the properties of an object
+		 *
+		 * \note Fails to compile if two members of T have the same name
+		 */
+		template<class T>
+		constexpr auto make_storage_order()
+		{
+			constexpr auto N = member_count<T>;
+			std::array<property_name, N> names{};
+			[&names]<size_t... I>(std::index_sequence<I...>) {
+				((names[I] = get_member<I, T>().name), ...);
+			}(std::make_index_sequence<N>{});
+
+			std::array<size_t, N> ret{};
+			for(size_t k = 0; k != N; ++k)
+			{ ret[k] = k; }
+
+			std::ranges::sort(ret, [&names](auto a, auto b) {
+				return std::string_view{names[a]} < std::string_view{names[b]};
+			});
+
+			for(size_t k = 1; k < N; ++k)
+			{
+				if(std::string_view{names[ret[k - 1]]} == std::string_view{names[ret[k]]})
+				{ throw std::logic_error{"Duplicate member name in schema"}; }
+			}
+
+			return ret;
+		}
+
+		template<class T>
+		constexpr auto storage_order = make_storage_order<T>();
+
+		/**
+		 * \brief Maps T to the corresponding element type in object::mapped_type
+		 */
+		template<class T>
+		using value_type_of = std::conditional_t<described<T>, object, T>;
+
+		template<class T>
+		struct is_vector : std::false_type
+		{};
+
+		template<class T, class Allocator>
+		struct is_vector<std::vector<T, Allocator>> : std::true_type
+		{};
+
+		using scalar_value = std::variant<int32_t, int64_t, uint32_t, uint64_t, float, double,
+			std::string_view>;
+
+		using element_span = std::variant<std::span<int32_t const>, std::span<int64_t const>,
+			std::span<uint32_t const>, std::span<uint64_t const>, std::span<float const>,
+			std::span<double const>>;
+
+		struct value_ops;
+
+		/**
+		 * \brief The destination of the value following a key. If ops is nullptr, the value is
+		 * skipped.
+		 */
+		struct target
+		{
+			void* ptr;
+			value_ops const* ops;
+			std::string_view name;
+			size_t index;
+		};
+
+		struct frame_ops;
+
+		/**
+		 * \brief A struct or an array that is currently being filled
+		 */
+		struct frame
+		{
+			void* ptr;
+			frame_ops const* ops;
+			size_t first_member{0};
+		};
+
+		struct value_ops
+		{
+			void (*assign)(void* ptr, scalar_value const& value, std::string_view name);
+			frame (*begin_object)(void* ptr, std::string_view name);
+			frame (*begin_array)(void* ptr, size_t type_index, std::string_view name);
+		};
+
+		struct frame_ops
+		{
+			size_t member_count;
+			target (*key)(void* ptr, std::string_view key);
+			void (*element)(void* ptr, scalar_value const& value);
+			void (*elements)(void* ptr, element_span const& values);
+			frame (*begin_element)(void* ptr);
+		};
+
+		[[noreturn]] inline void type_mismatch(std::string_view name)
+		{
+			throw std::runtime_error{std::string{"Type mismatch for property "}.append(name)};
+		}
+
+		template<class T>
+		constexpr bool is_scalar_v = std::is_arithmetic_v<T> || std::is_same_v<T, std::string>;
+
+		template<class T>
+		void assign(T& dest, scalar_value const& value, std::string_view name)
+		{
+			if constexpr(std::is_same_v<T, std::string>)
+			{
+				if(auto src = std::get_if<std::string_view>(&value); src != nullptr)
+				{
+					dest = *src;
+					return;
+				}
+			}
+			else
+			if constexpr(std::is_arithmetic_v<T>)
+			{
+				if(auto src = std::get_if<T>(&value); src != nullptr)
+				{
+					dest = *src;
+					return;
+				}
+			}
+			type_mismatch(name);
+		}
+
+		template<class T>
+		struct struct_ops;
+
+		template<class T>
+		struct array_ops;
+
+		template<class T>
+		struct member_ops
+		{
+			static void assign(void* ptr, scalar_value const& value, std::string_view name)
+			{ schema_detail::assign(*static_cast<T*>(ptr), value, name); }
+
+			static frame begin_object(void* ptr, std::string_view name)
+			{
+				if constexpr(described<T>)
+				{ return frame{ptr, &struct_ops<T>::ops}; }
+				else
+				{ type_mismatch(name); }
+			}
+
+			static frame begin_array(void* ptr, size_t type_index, std::string_view name)
+			{
+				if constexpr(is_vector<T>::value)
+				{
+					constexpr auto expected_index = variant_helper::index_of<
+						std::vector<value_type_of<typename T::value_type>>, object::mapped_type>;
+					static_assert(expected_index != std::variant_npos, "Unsupported array type");
+					if(type_index == expected_index)
+					{ return frame{ptr, &array_ops<T>::ops}; }
+				}
+				type_mismatch(name);
+			}
+
+			static constexpr value_ops ops{assign, begin_object, begin_array};
+		};
+
+		[[noreturn]] inline void not_an_array()
+		{ throw std::runtime_error{"Unexpected array element"}; }
+
+		template<class T>
+		struct struct_ops
+		{
+			/**
+			 * \brief Looks up the member called name. Since all names are known at compile-time, this
+			 * is a sequence of comparisons, starting with the hash value.
+			 */
+			static target key(void* ptr, std::string_view name)
+			{
+				auto const hash = property_name_hash(name);
+				auto& obj = *static_cast<T*>(ptr);
+				target ret{nullptr, nullptr, name, 0};
+				[&]<size_t... I>(std::index_sequence<I...>) {
+					(void)((hash == get_member<I, T>().name.hash()
+						&& name == std::string_view{get_member<I, T>().name}
+						&& (ret = target{&(obj.*(get_member<I, T>().ptr)),
+							&member_ops<member_type<I, T>>::ops,
+							std::string_view{get_member<I, T>().name}, I}, true)) || ...);
+				}(std::make_index_sequence<member_count<T>>{});
+				return ret;
+			}
+
+			static void element(void*, scalar_value const&)
+			{ not_an_array(); }
+
+			static void elements(void*, element_span const&)
+			{ not_an_array(); }
+
+			static frame begin_element(void*)
+			{ not_an_array(); }
+
+			static constexpr frame_ops ops{member_count<T>, key, element, elements, begin_element};
+		};
+
+		template<class T>
+		struct array_ops
+		{
+			using element_type = typename T::value_type;
+
+			static target key(void*, std::string_view)
+			{ throw std::runtime_error{"Unexpected key in array"}; }
+
+			static void element(void* ptr, scalar_value const& value)
+			{
+				if constexpr(is_scalar_v<element_type>)
+				{ assign(static_cast<T*>(ptr)->emplace_back(), value, "array element"); }
+				else
+				{ type_mismatch("array element"); }
+			}
+
+			static void elements(void* ptr, element_span const& values)
+			{
+				if constexpr(std::is_arithmetic_v<element_type>)
+				{
+					if(auto src = std::get_if<std::span<element_type const>>(&values); src != nullptr)
+					{
+						auto& array = *static_cast<T*>(ptr);
+						array.insert(std::end(array), std::begin(*src), std::end(*src));
+						return;
+					}
+				}
+				type_mismatch("array element");
+			}
+
+			static frame begin_element(void* ptr)
+			{
+				if constexpr(described<element_type>)
+				{ return frame{&static_cast<T*>(ptr)->emplace_back(), &struct_ops<element_type>::ops}; }
+				else
+				{ type_mismatch("array element"); }
+			}
+
+			static constexpr frame_ops ops{0, key, element, elements, begin_element};
+		};
+	}
+
+	/**
+	 * \brief An event handler, that fills a described struct from the events reported by an
+	 * event_parser
+	 *
+	 * Values are written directly into the members of the struct, without building any object.
+	 * Properties that are not part of the schema are skipped by the event_parser. Members that do
+	 * not appear in the input keep their previous value. Just like when loading an object, a
+	 * property that appears twice results in an exception.
+	 *
+	 * \ingroup schema
+	 */
+	template<described T>
+	class struct_builder
+	{
+	public:
+		explicit struct_builder(T& dest):m_dest{&dest}, m_target{}
+		{}
+
+		/**
+		 * \brief Selects the member called name
+		 *
+		 * \return false if there is no such member, so the event_parser skips the value
+		 *
+		 * \note If the member has already been assigned from the current object, an exception is
+		 * thrown
+		 */
+		bool on_key(std::string_view name)
+		{
+			auto const& current = m_frames.back();
+			m_target = current.ops->key(current.ptr, name);
+			m_has_target = m_target.ops != nullptr;
+			if(m_has_target)
+			{
+				auto assigned = m_assigned[current.first_member + m_target.index];
+				if(assigned)
+				{ throw std::runtime_error{"Key already exists"}; }
+				assigned = true;
+			}
+			return m_has_target;
+		}
+
+		void on_begin_object()
+		{
+			if(std::size(m_frames) == 0)
+			{ push_frame(schema_detail::frame{m_dest, &schema_detail::struct_ops<T>::ops}); }
+			else
+			if(take_target())
+			{ push_frame(m_target.ops->begin_object(m_target.ptr, m_target.name)); }
+			else
+			{ push_frame(m_frames.back().ops->begin_element(m_frames.back().ptr)); }
+		}
+
+		void on_end_object()
+		{ pop_frame(); }
+
+		template<class U>
+		void on_begin_array(std::type_identity<U>)
+		{
+			if(!take_target())
+			{ schema_detail::type_mismatch("outermost value"); }
+
+			constexpr auto type_index = variant_helper::index_of<std::vector<U>, object::mapped_type>;
+			push_frame(m_target.ops->begin_array(m_target.ptr, type_index, m_target.name));
+		}
+
+		void on_end_array()
+		{ pop_frame(); }
+
+		template<class U>
+		void on_scalar(U value)
+		{
+			if(std::size(m_frames) == 0)
+			{ schema_detail::type_mismatch("outermost value"); }
+
+			if(take_target())
+			{ m_target.ops->assign(m_target.ptr, schema_detail::scalar_value{value}, m_target.name); }
+		}
+
+		template<class U>
+		void on_array_element(U value)
+		{ m_frames.back().ops->element(m_frames.back().ptr, schema_detail::scalar_value{value}); }
+
+		template<class U>
+		void on_array_elements(std::span<U const> values)
+		{ m_frames.back().ops->elements(m_frames.back().ptr, schema_detail::element_span{values}); }
+
+	private:
+		T* m_dest;
+		schema_detail::target m_target;
+		bool m_has_target{false};
+		std::vector<schema_detail::frame> m_frames;
+
+		// One flag per member of every open struct, that is set when the member has been assigned
+		std::vector<bool> m_assigned;
+
+		void push_frame(schema_detail::frame frame)
+		{
+			frame.first_member = std::size(m_assigned);
+			m_assigned.resize(std::size(m_assigned) + frame.ops->member_count, false);
+			m_frames.push_back(frame);
+		}
+
+		void pop_frame()
+		{
+			m_assigned.resize(m_frames.back().first_member);
+			m_frames.pop_back();
+		}
+
+		bool take_target()
+		{
+			auto const ret = m_has_target;
+			m_has_target = false;
+			return ret;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,239 @@
+//@	{"target":{"name":"schema.test"}}
+
+#include "./schema.hpp"
+#include "./deserializer.hpp"
+#include "./serializer.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+namespace
+{
+	struct point
+	{
+		double x;
+		double y;
+		std::string label;
+	};
+
+	struct shape
+	{
+		std::string name;
+		uint64_t id;
+		int32_t layer;
+		point center;
+		std::vector<point> points;
+		std::vector<std::string> tags;
+		std::vector<float> weights;
+	};
+}
+
+template<>
+struct anon::schema<point>
+{
+	static constexpr std::tuple members{
+		anon::member{"x", &point::x},
+		anon::member{"y", &point::y},
+		anon::member{"label", &point::label}
+	};
+};
+
+template<>
+struct anon::schema<shape>
+{
+	static constexpr std::tuple members{
+		anon::member{"name", &shape::name},
+		anon::member{"id", &shape::id},
+		anon::member{"layer", &shape::layer},
+		anon::member{"center", &shape::center},
+		anon::member{"points", &shape::points},
+		anon::member{"tags", &shape::tags},
+		anon::member{"weights", &shape::weights}
+	};
+};
+
+namespace
+{
+	static_assert(anon::described<point>);
+	static_assert(anon::described<shape>);
+	static_assert(!anon::described<anon::object>);
+	static_assert(!anon::described<int>);
+	static_assert(std::string_view{anon::type_info<std::vector<shape>>::name()} == "obj*");
+
+	struct buffer
+	{
+		explicit buffer(std::string_view sv):data{sv}, ptr{std::begin(data)}
+		{}
+
+		std::string_view data;
+		char const* ptr;
+	};
+
+	anon::read_result read_byte(buffer& buff)
+	{
+		auto ret_val = buff.ptr != std::end(buff.data)? *buff.ptr : '\0';
+		auto ret_status = buff.ptr != std::end(buff.data) ?
+			anon::stream_status::ready: anon::stream_status::eof;
+		++buff.ptr;
+
+		return anon::read_result{ret_val, ret_status};
+	}
+
+	struct chunked_buffer
+	{
+		explicit chunked_buffer(std::string_view sv, size_t chunk_size):
+			data{sv},
+			ptr{std::begin(data)},
+			chunk_size{chunk_size}
+		{}
+
+		std::string_view data;
+		char const* ptr;
+		size_t chunk_size;
+	};
+
+	anon::chunk_read_result read_chunk(chunked_buffer& buff)
+	{
+		auto const n = std::min(buff.chunk_size, static_cast<size_t>(std::end(buff.data) - buff.ptr));
+		if(n == 0)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::eof}; }
+
+		auto const ret = std::span{buff.ptr, n};
+		buff.ptr += n;
+		return anon::chunk_read_result{ret, anon::stream_status::ready};
+	}
+
+	constexpr std::string_view shape_src{R"(obj{
+	name: str{A triangle with \\ and \}
+	id: u64{18446744073709551615\}
+	layer: i32{-3\}
+	unknown_object: obj{
+		name: str{Should be ignored\}
+		nested: obj*{a: i32{1\}\;b: f64*{1\;2\;\}\;\}
+	\}
+	center: obj{x: f64{0.5\} y: f64{0.25\} label: str{Center\}\}
+	unknown_scalar: str{Also ignored\}
+	points: obj*{
+		x: f64{0\} y: f64{0\}\;
+		x: f64{1\} y: f64{0\} label: str{Second\}\;
+		x: f64{0\} y: f64{1\} color: str{red\}\;
+	\}
+	tags: str*{first\;second\;\}
+	unknown_array: i32*{1\;2\;3\;\}
+	weights: f32*{0.5\;1.5\;2.5\;\}
+\})"};
+
+	void check_shape(shape const& value)
+	{
+		EXPECT_EQ(value.name, R"(A triangle with \ and )");
+		EXPECT_EQ(value.id, 18446744073709551615u);
+		EXPECT_EQ(value.layer, -3);
+		EXPECT_EQ(value.center.x, 0.5);
+		EXPECT_EQ(value.center.y, 0.25);
+		EXPECT_EQ(value.center.label, "Center");
+		REQUIRE_EQ(std::size(value.points), 3);
+		EXPECT_EQ(value.points[1].x, 1.0);
+		EXPECT_EQ(value.points[1].label, "Second");
+		EXPECT_EQ(value.points[2].y, 1.0);
+		EXPECT_EQ(value.points[2].label, "");
+		EXPECT_EQ(value.tags, (std::vector<std::string>{"first", "second"}));
+		EXPECT_EQ(value.weights, (std::vector<float>{0.5f, 1.5f, 2.5f}));
+	}
+}
+
+TESTCASE(anon_schema_load)
+{
+	{
+		buffer buff{shape_src};
+		check_shape(anon::load<shape>(buff));
+	}
+
+	for(size_t chunk_size : {1, 2, 7, 4096})
+	{
+		chunked_buffer buff{shape_src, chunk_size};
+		check_shape(anon::load<shape>(buff));
+	}
+}
+
+TESTCASE(anon_schema_store)
+{
+	buffer buff{shape_src};
+	auto const value = anon::load<shape>(buff);
+
+	auto const str = anon::to_string(value);
+	EXPECT_EQ(str, R"(obj{center:obj{label:str{Center\}x:f64{5e-01\}y:f64{2.5e-01\}\})"
+		R"(id:u64{18446744073709551615\}layer:i32{-3\}name:str{A triangle with \\ and \})"
+		R"(points:obj*{label:str{\}x:f64{0e+00\}y:f64{0e+00\}\;)"
+		R"(label:str{Second\}x:f64{1e+00\}y:f64{0e+00\}\;)"
+		R"(label:str{\}x:f64{0e+00\}y:f64{1e+00\}\;\})"
+		R"(tags:str*{first\;second\;\}weights:f32*{5e-01\;1.5e+00\;2.5e+00\;\}\})");
+
+	buffer obj_buff{str};
+	EXPECT_EQ(anon::to_string(anon::load(obj_buff)), str);
+
+	buffer round_trip{str};
+	check_shape(anon::load<shape>(round_trip));
+}
+
+TESTCASE(anon_schema_type_mismatch)
+{
+	for(auto const src : {R"(obj{x: f32{1\}\})", R"(obj{x: str{1\}\})", R"(obj{label: obj{\}\})",
+		R"(obj{label: str*{\}\})", R"(str{1\})", R"(i32*{1\;\})"})
+	{
+		try
+		{
+			buffer buff{src};
+			(void)anon::load<point>(buff);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+
+	for(auto const src : {R"(obj{points: f64*{1\;\}\})", R"(obj{points: obj{\}\})",
+		R"(obj{weights: f64*{1\;\}\})", R"(obj{center: obj*{\}\})"})
+	{
+		try
+		{
+			buffer buff{src};
+			(void)anon::load<shape>(buff);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+}
+
+TESTCASE(anon_schema_duplicate_key)
+{
+	for(auto const src : {R"(obj{name: str{a\} name: str{b\}\})",
+		R"(obj{center: obj{x: f64{1\} y: f64{1\} x: f64{2\}\}\})",
+		R"(obj{points: obj*{x: f64{1\}\;y: f64{1\} y: f64{2\}\;\}\})",
+		R"(obj{tags: str*{a\;\} tags: str*{b\;\}\})"})
+	{
+		std::string object_error;
+		try
+		{
+			buffer buff{src};
+			(void)anon::load(buff);
+		}
+		catch(std::runtime_error const& err)
+		{ object_error = err.what(); }
+		EXPECT_EQ(object_error, "Key already exists");
+
+		try
+		{
+			buffer buff{src};
+			(void)anon::load<shape>(buff);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const& err)
+		{ EXPECT_EQ(err.what(), object_error); }
+	}
+
+	// The same name may appear in different objects
+	buffer buff{R"(obj{name: str{a\} center: obj{label: str{b\} x: f64{1\}\} points: obj*{x: f64{1\}\;x: f64{2\}\;\}\})"};
+	auto const value = anon::load<shape>(buff);
+	EXPECT_EQ(value.center.x, 1.0);
+	REQUIRE_EQ(std::size(value.points), 2);
+	EXPECT_EQ(value.points[1].x, 2.0);
+}
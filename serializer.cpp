@@ -0,0 +1,27 @@
+//@	{"target":{"name":"serializer.o"}}
+
+#include "./serializer.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <unistd.h>
+
+void anon::write(std::span<char const> buffer, fd_writer writer)
+{
+	auto ptr = std::data(buffer);
+	auto bytes_left = std::size(buffer);
+	while(bytes_left != 0)
+	{
+		auto const n = ::write(writer.fd, ptr, bytes_left);
+		if(n == -1)
+		{
+			if(errno == EINTR)
+			{ continue; }
+			throw std::runtime_error{std::string{"Failed to write data: "}.append(strerror(errno))};
+		}
+		ptr += n;
+		bytes_left -= static_cast<size_t>(n);
+	}
+}
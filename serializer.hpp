@@ -1,3 +1,5 @@
+//@	{"dependencies_extra":[{"ref":"./serializer.o","rel":"implementation"}]}
+
 #ifndef ANON_SERIALIZER_HPP
 #define ANON_SERIALIZER_HPP
 
@@ -8,6 +10,8 @@
  */
 
 #include "./type_info.hpp"
+#include "./schema.hpp"
+#include "./scanner.hpp"
 
 #include <filesystem>
 #include <cstdio>
@@ -15,6 +19,8 @@
 #include <array>
 #include <charconv>
 #include <cstring>
+#include <limits>
+#include <span>
 
 /**
  * \defgroup serialization Serialization
@@ -23,21 +29,99 @@
 namespace anon
 {
 	/**
-	 * \brief Defines the requirements of a "sink"
-	 *
-	 * A sink is something that can be written to, for example, an output buffer or a file. It shall
-	 * support writing single characters as well as C-style strings.
+	 * \brief Defines the requirements of a sink that supports writing single characters as well
+	 * as C-style strings
 	 *
 	 * \ingroup serialization
 	 *
 	 */
 	template<class T>
-	concept sink = requires(T a)
+	concept char_sink = requires(T a)
 	{
 		{ write(std::declval<char>(), a) } -> std::same_as<void>;
 		{ write(std::declval<char const*>(), a) } -> std::same_as<void>;
 	};
 
+	/**
+	 * \brief Defines the requirements of a sink that supports writing a block of characters
+	 *
+	 * \ingroup serialization
+	 *
+	 */
+	template<class T>
+	concept bulk_sink = requires(T a)
+	{
+		{ write(std::declval<std::span<char const>>(), a) } -> std::same_as<void>;
+	};
+
+	/**
+	 * \brief Defines the requirements of a "sink"
+	 *
+	 * A sink is something that can be written to, for example, an output buffer or a file. It shall
+	 * either support writing single characters as well as C-style strings, or blocks of characters.
+	 * If both ways of writing are supported, blocks are written whenever possible.
+	 *
+	 * \ingroup serialization
+	 *
+	 */
+	template<class T>
+	concept sink = char_sink<T> || bulk_sink<T>;
+
+	namespace serializer_detail
+	{
+		template<sink Sink>
+		void emit(std::span<char const> data, Sink& sink)
+		{
+			if constexpr(bulk_sink<Sink>)
+			{ write(data, sink); }
+			else
+			{
+				std::ranges::for_each(data, [&sink](auto item) {
+					write(item, sink);
+				});
+			}
+		}
+
+		template<sink Sink>
+		void emit(std::string_view data, Sink& sink)
+		{ emit(std::span{std::data(data), std::size(data)}, sink); }
+
+		template<sink Sink>
+		void emit(char ch, Sink& sink)
+		{
+			if constexpr(char_sink<Sink>)
+			{ write(ch, sink); }
+			else
+			{ write(std::span{&ch, 1}, sink); }
+		}
+
+		/**
+		 * \brief The maximum number of characters needed to format a T
+		 *
+		 * Floating point numbers are written in scientific notation, so the space needed is a sign,
+		 * max_digits10 digits, a decimal point, and an exponent of at most 4 digits with its own
+		 * sign.
+		 */
+		template<class T>
+		constexpr size_t max_chars = std::is_integral_v<T>?
+			std::numeric_limits<T>::digits10 + 2 : std::numeric_limits<T>::max_digits10 + 8;
+
+		/**
+		 * \brief Formats value into [begin, end), which must hold at least max_chars<T> characters
+		 *
+		 * \return A pointer to the end of the formatted number
+		 */
+		template<class T>
+		requires(std::is_arithmetic_v<T>)
+		char* format_number(char* begin, char* end, T value)
+		{
+			if constexpr(std::is_integral_v<T>)
+			{ return std::to_chars(begin, end, value).ptr; }
+			else
+			{ return std::to_chars(begin, end, value, std::chars_format::scientific).ptr; }
+		}
+	}
+
 	/**
 	 * \brief Writes item to sink, within type_info<Entity>::name()`{` and `\}`
 	 *
@@ -51,21 +135,33 @@ namespace anon
 	 *
 	 * \ingroup serialization
 	 */
-	template<sink Sink>
-	void store_body(object const& obj, Sink&& sink);
+	template<class Storage, sink Sink>
+	void store_body(basic_object<Storage> const& obj, Sink&& sink);
+
+	/**
+	 * \brief Writes the members of item to sink
+	 *
+	 * Members are written in the same order as the properties of an object, which is sorted by
+	 * name. The order is computed at compile-time.
+	 *
+	 * \ingroup schema
+	 */
+	template<described T, sink Sink>
+	void store_body(T const& item, Sink&& sink);
 
 	/**
 	 * \brief Writes `array` to sink
 	 *
 	 * This function writes `array` to sink. To separate the elements, the sequence `\;` is written
-	 * directly after the element.
+	 * directly after the element. Arrays of numbers are formatted into a local buffer, which is
+	 * passed to sink in large blocks.
 	 *
 	 * \note Array elements are written using store_body, rather than store
 	 *
 	 * \ingroup serialization
 	 */
-	template<class T, sink Sink>
-	void store_body(std::vector<T> const& array, Sink&& sink);
+	template<class T, class Allocator, sink Sink>
+	void store_body(std::vector<T, Allocator> const& array, Sink&& sink);
 
 	/**
 	 * \brief Writes value to sink
@@ -94,6 +190,15 @@ namespace anon
 	template<sink Sink>
 	void store_body(std::string_view value, Sink&& sink);
 
+	/**
+	 * \brief Writes the elements of value to sink, like the wrapped container
+	 *
+	 * \ingroup serialization
+	 */
+	template<class Container, sink Sink>
+	void store_body(cow_sequence<Container> const& value, Sink&& sink)
+	{ store_body(value.get(), sink); }
+
 	/**
 	 * \brief Writes value to sink.
 	 *
@@ -101,66 +206,120 @@ namespace anon
 	 */
 	template<sink Sink>
 	void store_body(property_name const& value, Sink&& sink)
-	{ write(value.c_str(), sink); }
-
+	{ serializer_detail::emit(std::string_view{value}, sink); }
 
+	/**
+	 * \brief Writes value to sink.
+	 *
+	 * \ingroup serialization
+	 */
 	template<sink Sink>
-	void store_body(object const& obj, Sink&& sink)
+	void store_body(interned_name const& value, Sink&& sink)
+	{ serializer_detail::emit(std::string_view{value}, sink); }
+
+
+	template<class Storage, sink Sink>
+	void store_body(basic_object<Storage> const& obj, Sink&& sink)
 	{
 		std::ranges::for_each(obj, [&sink](auto const& item){
 			store_body(item.first, sink);
-			write(':', sink);
+			serializer_detail::emit(':', sink);
 			std::visit([&sink](auto const& item) {
 				store(item, sink);
 			}, item.second);
 		});
 	}
 
-	template<class T, sink Sink>
-	void store_body(std::vector<T> const& array, Sink&& sink)
+	template<described T, sink Sink>
+	void store_body(T const& item, Sink&& sink)
 	{
-		std::ranges::for_each(array, [&sink](auto const& item){
-			store_body(item, sink);
-			write("\\;", sink);
-		});
+		[&item, &sink]<size_t... I>(std::index_sequence<I...>) {
+			([&item, &sink]<size_t Index>(std::integral_constant<size_t, Index>) {
+				auto const& member = schema_detail::get_member<Index, T>();
+				store_body(member.name, sink);
+				serializer_detail::emit(':', sink);
+				store(item.*(member.ptr), sink);
+			}(std::integral_constant<size_t, schema_detail::storage_order<T>[I]>{}), ...);
+		}(std::make_index_sequence<schema_detail::member_count<T>>{});
+	}
+
+	template<class T, class Allocator, sink Sink>
+	void store_body(std::vector<T, Allocator> const& array, Sink&& sink)
+	{
+		if constexpr(std::is_arithmetic_v<T>)
+		{
+			constexpr auto max_element_size = serializer_detail::max_chars<T> + 2;
+			std::array<char, 4096> buffer;
+			auto const begin = std::data(buffer);
+			auto const end = begin + std::size(buffer);
+			auto ptr = begin;
+			for(auto item : array)
+			{
+				if(static_cast<size_t>(end - ptr) < max_element_size)
+				{
+					serializer_detail::emit(std::span{begin, ptr}, sink);
+					ptr = begin;
+				}
+				ptr = serializer_detail::format_number(ptr, end, item);
+				*ptr++ = '\\';
+				*ptr++ = ';';
+			}
+			serializer_detail::emit(std::span{begin, ptr}, sink);
+		}
+		else
+		{
+			std::ranges::for_each(array, [&sink](auto const& item){
+				store_body(item, sink);
+				serializer_detail::emit(std::string_view{"\\;"}, sink);
+			});
+		}
 	}
 
 	template<std::integral T, sink Sink>
 	void store_body(T value, Sink&& sink)
 	{
-		std::array<char, std::numeric_limits<T>::digits10 + 2> buffer{};
-		std::to_chars(std::begin(buffer), std::end(buffer), value);
-		write(std::data(buffer), sink);
+		std::array<char, serializer_detail::max_chars<T>> buffer;
+		auto const end = serializer_detail::format_number(std::data(buffer),
+			std::data(buffer) + std::size(buffer), value);
+		serializer_detail::emit(std::span{std::data(buffer), end}, sink);
 	}
 
 	template<std::floating_point T, sink Sink>
 	void store_body(T value, Sink&& sink)
 	{
-		std::array<char, std::numeric_limits<T>::digits10 + 7> buffer{};
-		std::to_chars(std::begin(buffer), std::end(buffer), value, std::chars_format::scientific);
-		write(std::data(buffer), sink);
+		std::array<char, serializer_detail::max_chars<T>> buffer;
+		auto const end = serializer_detail::format_number(std::data(buffer),
+			std::data(buffer) + std::size(buffer), value);
+		serializer_detail::emit(std::span{std::data(buffer), end}, sink);
 	}
 
 	template<sink Sink>
 	void store_body(std::string_view value, Sink&& sink)
 	{
-		std::ranges::for_each(value, [&sink](auto item) {
-			if(item == '\0')
+		auto ptr = std::data(value);
+		auto const end = ptr + std::size(value);
+		while(true)
+		{
+			auto const run_end = scanner::find_value_delimiter(ptr, end);
+			serializer_detail::emit(std::span{ptr, run_end}, sink);
+			if(run_end == end)
+			{ return; }
+
+			if(*run_end == '\0')
 			{ throw std::runtime_error{"Cannot serialize null characters"}; }
 
-			if(item == '\\')
-			{ write('\\', sink); }
-			write(item, sink);
-		});
+			serializer_detail::emit(std::string_view{"\\\\"}, sink);
+			ptr = run_end + 1;
+		}
 	}
 
 	template<class Entity, sink Sink>
 	void store(Entity const& item, Sink&& sink)
 	{
-		write(type_info<Entity>::name(), sink);
-		write('{', sink);
+		serializer_detail::emit(std::string_view{type_info<Entity>::name()}, sink);
+		serializer_detail::emit('{', sink);
 		store_body(item, sink);
-		write("\\}", sink);
+		serializer_detail::emit(std::string_view{"\\}"}, sink);
 	}
 
 	/**
@@ -193,14 +352,173 @@ namespace anon
 		fputs(buffer, writer.sink);
 	}
 
+	/**
+	 * \brief Writes buffer to the stream referred to by writer
+	 *
+	 * \ingroup serialization
+	 */
+	inline void write(std::span<char const> buffer, cfile_writer writer)
+	{
+		fwrite(std::data(buffer), 1, std::size(buffer), writer.sink);
+	}
+
+	/**
+	 * \brief An adapter to make it possible to write objects directly to a file descriptor
+	 *
+	 * \ingroup serialization
+	 */
+	struct fd_writer
+	{
+		int fd;
+	};
+
+	/**
+	 * \brief Writes buffer to the file descriptor referred to by writer
+	 *
+	 * \note If not all data could be written, an exception is thrown
+	 *
+	 * \ingroup serialization
+	 */
+	void write(std::span<char const> buffer, fd_writer writer);
+
+	/**
+	 * \brief A sink that collects data in a fixed-size buffer, and forwards it to Sink in large
+	 * blocks
+	 *
+	 * \note Call flush before the writer is destroyed to ensure that any errors from Sink are
+	 * reported. The destructor tries to flush remaining data, but ignores any errors.
+	 *
+	 * \ingroup serialization
+	 */
+	template<bulk_sink Sink, size_t Capacity = 65536>
+	class buffered_writer
+	{
+	public:
+		explicit buffered_writer(Sink sink):
+			m_sink{sink},
+			m_buffer{std::make_unique<char[]>(Capacity)},
+			m_size{0}
+		{}
+
+		buffered_writer(buffered_writer const&) = delete;
+		buffered_writer& operator=(buffered_writer const&) = delete;
+
+		~buffered_writer()
+		{
+			try
+			{ flush(); }
+			catch(...)
+			{}
+		}
+
+		/**
+		 * \brief Appends ch to the buffer
+		 */
+		void push_back(char ch)
+		{
+			if(m_size == Capacity)
+			{ flush(); }
+			m_buffer[m_size] = ch;
+			++m_size;
+		}
+
+		/**
+		 * \brief Appends data to the buffer
+		 *
+		 * If data does not fit in the remaining space, the buffer is flushed first. Blocks that
+		 * are larger than the buffer itself are forwarded directly to the sink.
+		 */
+		void append(std::span<char const> data)
+		{
+			if(std::size(data) > Capacity - m_size)
+			{
+				flush();
+				if(std::size(data) >= Capacity)
+				{
+					write(data, m_sink);
+					return;
+				}
+			}
+			std::copy(std::begin(data), std::end(data), m_buffer.get() + m_size);
+			m_size += std::size(data);
+		}
+
+		/**
+		 * \brief Forwards all buffered data to the sink
+		 */
+		void flush()
+		{
+			if(m_size != 0)
+			{
+				auto const size = m_size;
+				m_size = 0;
+				write(std::span<char const>{m_buffer.get(), size}, m_sink);
+			}
+		}
+
+	private:
+		Sink m_sink;
+		std::unique_ptr<char[]> m_buffer;
+		size_t m_size;
+	};
+
+	/**
+	 * \brief Writes ch to writer
+	 *
+	 * \ingroup serialization
+	 */
+	template<class Sink, size_t Capacity>
+	void write(char ch, buffered_writer<Sink, Capacity>& writer)
+	{
+		writer.push_back(ch);
+	}
+
+	/**
+	 * \brief Writes buffer to writer
+	 *
+	 * \ingroup serialization
+	 */
+	template<class Sink, size_t Capacity>
+	void write(char const* buffer, buffered_writer<Sink, Capacity>& writer)
+	{
+		writer.append(std::span{buffer, std::strlen(buffer)});
+	}
+
+	/**
+	 * \brief Writes buffer to writer
+	 *
+	 * \ingroup serialization
+	 */
+	template<class Sink, size_t Capacity>
+	void write(std::span<char const> buffer, buffered_writer<Sink, Capacity>& writer)
+	{
+		writer.append(buffer);
+	}
+
 	/**
 	 * \brief Stores obj to dest
 	 *
 	 * \ingroup serialization
 	 */
-	inline void store(object const& obj, FILE* dest)
+	template<class Storage>
+	void store(basic_object<Storage> const& obj, FILE* dest)
+	{
+		buffered_writer writer{cfile_writer{dest}};
+		store(obj, writer);
+		writer.flush();
+	}
+
+	/**
+	 * \brief Stores obj to the file descriptor fd
+	 *
+	 * \ingroup serialization
+	 */
+	template<class Storage>
+	void store(basic_object<Storage> const& obj, fd_writer dest)
 	{
-		store(obj, cfile_writer{dest});
+		buffered_writer writer{dest};
+		store(obj, writer);
+		writer.flush();
 	}
 
 	/**
@@ -210,7 +528,8 @@ namespace anon
 	 *
 	 * \ingroup serialization
 	 */
-	inline void store(object const& obj, std::filesystem::path const& path)
+	template<class Storage>
+	void store(basic_object<Storage> const& obj, std::filesystem::path const& path)
 	{
 		auto file_deleter = [](FILE* f){ return fclose(f); };
 		std::unique_ptr<FILE, decltype(file_deleter)> sink{fopen(path.c_str(), "wb")};
@@ -236,7 +555,7 @@ namespace anon
 	 *
 	 * \ingroup serialization
 	 */
-	void write(char ch, string_writer writer)
+	inline void write(char ch, string_writer writer)
 	{
 		writer.buffer.get() += ch;
 	}
@@ -246,21 +565,45 @@ namespace anon
 	 *
 	 * \ingroup serialization
 	 */
-	void write(char const* data, string_writer writer)
+	inline void write(char const* data, string_writer writer)
 	{
 		writer.buffer.get() += data;
 	}
 
+	/**
+	 * \brief Writes data to the string referred to by writer
+	 *
+	 * \ingroup serialization
+	 */
+	inline void write(std::span<char const> data, string_writer writer)
+	{
+		writer.buffer.get().append(std::data(data), std::size(data));
+	}
+
 	/**
 	 * \brief Generates a string representation of obj
 	 *
 	 * \ingroup serialization
 	 */
-	inline auto to_string(object const& obj)
+	template<class Storage>
+	auto to_string(basic_object<Storage> const& obj)
 	{
 		std::string ret;
 		store(obj, string_writer{ret});
 		return ret;
 	}
+
+	/**
+	 * \brief Generates a string representation of item
+	 *
+	 * \ingroup schema
+	 */
+	template<described T>
+	std::string to_string(T const& item)
+	{
+		std::string ret;
+		store(item, string_writer{ret});
+		return ret;
+	}
 }
 #endif
\ No newline at end of file
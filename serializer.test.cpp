@@ -41,6 +41,29 @@ namespace
 	{
 		buff.buffer+=data;
 	}
+
+	struct bulk_writebuff
+	{
+		std::string buffer;
+		size_t write_count{0};
+	};
+
+	void write(std::span<char const> data, bulk_writebuff& buff)
+	{
+		buff.buffer.append(std::data(data), std::size(data));
+		++buff.write_count;
+	}
+
+	auto const test_data = R"(
+obj{
+	an_object: obj{
+		a_string: str{this is a test with \\ and { } \}
+		a_second_string: str{foobar\}
+	\}
+	an_array_of_strings: str*{First string\;Second \\string\;Third string\;\}
+	an_array_of_i32: i32*{1\;2\;3\;\}
+	an_f64: f64{1\}
+\})";
 }
 
 TESTCASE(anon_load_store_and_load)
@@ -84,4 +107,137 @@ obj{
 	auto obj_2 = anon::load(buffer{buff_out.buffer});
 
 	EXPECT_EQ(obj_1, obj_2);
-}
\ No newline at end of file
+}
+
+TESTCASE(anon_store_bulk_sink)
+{
+	auto const obj = anon::load(buffer{test_data});
+
+	writebuff char_buff{};
+	store(obj, char_buff);
+
+	bulk_writebuff bulk_buff{};
+	store(obj, bulk_buff);
+
+	EXPECT_EQ(char_buff.buffer, bulk_buff.buffer);
+	EXPECT_EQ(anon::to_string(obj), bulk_buff.buffer);
+	EXPECT_EQ(anon::load(buffer{bulk_buff.buffer}), obj);
+}
+
+TESTCASE(anon_store_buffered_writer)
+{
+	auto const obj = anon::load(buffer{test_data});
+	auto const expected = anon::to_string(obj);
+
+	bulk_writebuff bulk_buff{};
+	{
+		anon::buffered_writer<bulk_writebuff&, 16> writer{bulk_buff};
+		store(obj, writer);
+		writer.flush();
+	}
+	EXPECT_EQ(bulk_buff.buffer, expected);
+	EXPECT_EQ(bulk_buff.write_count > 1, true);
+
+	bulk_writebuff bulk_buff_2{};
+	{
+		anon::buffered_writer<bulk_writebuff&> writer{bulk_buff_2};
+		store(obj, writer);
+	}
+	EXPECT_EQ(bulk_buff_2.buffer, expected);
+	EXPECT_EQ(bulk_buff_2.write_count, 1);
+}
+
+TESTCASE(anon_store_null_character)
+{
+	anon::object obj;
+	obj.insert_or_assign("foo", std::string{"abc\0def", 7});
+
+	try
+	{
+		auto const str = anon::to_string(obj);
+		testcaseFailed();
+	}
+	catch(std::runtime_error const&)
+	{}
+}
+
+TESTCASE(anon_store_fd_writer)
+{
+	auto const obj = anon::load(buffer{test_data});
+
+	auto const f = tmpfile();
+	REQUIRE_EQ(f != nullptr, true);
+	store(obj, anon::fd_writer{fileno(f)});
+	rewind(f);
+
+	EXPECT_EQ(anon::load(f), obj);
+	fclose(f);
+}
+
+TESTCASE(anon_store_map_object)
+{
+	auto const obj = anon::load(buffer{test_data});
+
+	anon::map_object map_obj;
+	for(auto const& item : obj)
+	{
+		auto key = item.first;
+		std::visit([&map_obj, &key]<class T>(T const& val) {
+			if constexpr(!std::is_same_v<T, anon::object> && !std::is_same_v<T, std::vector<anon::object>>)
+			{ map_obj.insert(std::move(key), val); }
+		}, item.second);
+	}
+
+	anon::object flat_obj;
+	for(auto const& item : map_obj)
+	{
+		auto key = item.first;
+		std::visit([&flat_obj, &key]<class T>(T const& val) {
+			if constexpr(!std::is_same_v<T, anon::map_object> && !std::is_same_v<T, std::vector<anon::map_object>>)
+			{ flat_obj.insert(std::move(key), val); }
+		}, item.second);
+	}
+
+	EXPECT_EQ(std::size(map_obj), 3);
+	EXPECT_EQ(anon::to_string(map_obj), anon::to_string(flat_obj));
+}
+
+TESTCASE(anon_store_pmr_object)
+{
+	auto const obj = anon::load(buffer{test_data});
+
+	std::pmr::monotonic_buffer_resource arena;
+	auto const pmr_obj = anon::load(buffer{test_data}, arena);
+	EXPECT_EQ(anon::to_string(pmr_obj), anon::to_string(obj));
+}
+
+TESTCASE(anon_store_number_arrays)
+{
+	std::vector<double> doubles{-1.2345678901234567e-308, std::numeric_limits<double>::lowest(),
+		std::numeric_limits<double>::denorm_min(), -0.0, 0.1, 1.0/3.0};
+	std::vector<float> floats{-1.2345678e-38f, std::numeric_limits<float>::lowest(), 0.1f};
+	std::vector<int64_t> ints{std::numeric_limits<int64_t>::min(), 0, std::numeric_limits<int64_t>::max()};
+	for(size_t k = 0; k != 10000; ++k)
+	{
+		doubles.push_back(-1.0/static_cast<double>(k + 3));
+		ints.push_back(std::numeric_limits<int64_t>::min() + static_cast<int64_t>(k));
+	}
+
+	anon::object obj;
+	obj.insert_or_assign("doubles", doubles)
+		.insert_or_assign("floats", floats)
+		.insert_or_assign("ints", ints);
+
+	bulk_writebuff bulk_buff{};
+	store(obj, bulk_buff);
+	EXPECT_LT(bulk_buff.write_count, 200);
+
+	writebuff char_buff{};
+	store(obj, char_buff);
+	EXPECT_EQ(char_buff.buffer, bulk_buff.buffer);
+
+	auto const loaded = anon::load(buffer{bulk_buff.buffer});
+	EXPECT_EQ(std::get<std::vector<double>>(loaded["doubles"]), doubles);
+	EXPECT_EQ(std::get<std::vector<float>>(loaded["floats"]), floats);
+	EXPECT_EQ(std::get<std::vector<int64_t>>(loaded["ints"]), ints);
+}
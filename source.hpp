@@ -0,0 +1,106 @@
+#ifndef ANON_SOURCE_HPP
+#define ANON_SOURCE_HPP
+
+/**
+ * \file source.hpp
+ *
+ * \brief Contains the definition of the source concept, and its associated types
+ */
+
+#include <span>
+#include <concepts>
+
+namespace anon
+{
+	/**
+	 * \brief Defines the current status of a stream
+	 *
+	 * \ingroup de-serialization
+	 *
+	 */
+	enum class stream_status:char{ready, eof, blocking};
+
+	/**
+	 * \brief Holder for the result of a read operation
+	 *
+	 * \ingroup de-serialization
+	 */
+	struct read_result
+	{
+		/**
+		 * \brief Holds the last value read from a input stream, only useful of if status is ready.
+		 */
+		char value;
+
+		/**
+		 * \brief Determines the status of the input stream
+		 */
+		stream_status status;
+	};
+
+	/**
+	 * \brief Holder for the result of a bulk read operation
+	 *
+	 * \ingroup de-serialization
+	 */
+	struct chunk_read_result
+	{
+		/**
+		 * \brief Holds the data read from the input stream, only useful if status is ready.
+		 *
+		 * The data must stay valid until the next call to read_chunk on the same source.
+		 */
+		std::span<char const> data;
+
+		/**
+		 * \brief Determines the status of the input stream
+		 */
+		stream_status status;
+	};
+
+	/**
+	 * \brief Defines the requirements of a source that can be read one byte at a time
+	 *
+	 * \ingroup de-serialization
+	 *
+	 */
+	template<class T>
+	concept byte_source = requires(T a)
+	{
+		/**
+		 * \brief Shall try to consume next byte and return a read_result with appropriate values
+		 */
+		{ read_byte(a) } -> std::same_as<read_result>;
+	};
+
+	/**
+	 * \brief Defines the requirements of a source that can be read in larger chunks
+	 *
+	 * \ingroup de-serialization
+	 *
+	 */
+	template<class T>
+	concept chunked_source = requires(T a)
+	{
+		/**
+		 * \brief Shall try to consume all data that is available without blocking, and return a
+		 * chunk_read_result with appropriate values
+		 */
+		{ read_chunk(a) } -> std::same_as<chunk_read_result>;
+	};
+
+	/**
+	 * \brief Defines the requirements of a "source"
+	 *
+	 * A source is something that can be read from, for example, an input buffer or a file. It
+	 * must either be a byte_source or a chunked_source. If both ways of reading are supported,
+	 * read_chunk is used.
+	 *
+	 * \ingroup de-serialization
+	 *
+	 */
+	template<class T>
+	concept source = byte_source<T> || chunked_source<T>;
+}
+
+#endif
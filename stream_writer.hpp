@@ -0,0 +1,251 @@
+#ifndef ANON_STREAMWRITER_HPP
+#define ANON_STREAMWRITER_HPP
+
+/**
+ * \file stream_writer.hpp
+ *
+ * \brief Contains the definition of stream_writer
+ */
+
+#include "./serializer.hpp"
+#include "./property_name.hpp"
+#include "./type_info.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace anon
+{
+	/**
+	 * \brief Writes a document to a sink incrementally, without building an object first
+	 *
+	 * The document is produced by a sequence of calls, that mirror the structure of the output:
+	 *
+	 * ```
+	 * anon::stream_writer writer{sink};
+	 * writer.begin_object();
+	 * writer.key("name");
+	 * writer.value("Alice");
+	 * writer.key("rows");
+	 * writer.begin_array<anon::object>();
+	 * writer.begin_object();
+	 * writer.key("id");
+	 * writer.value(uint64_t{1});
+	 * writer.end();
+	 * writer.end();
+	 * writer.end();
+	 * ```
+	 *
+	 * The writer takes care of type tags and of the `\;` and `\}` sequences, and checks that the
+	 * calls form a valid document. Keys are validated as property names, and must be written in
+	 * strictly ascending order within each object. This is the same order as used by store, so the
+	 * output is identical to storing the corresponding object. If a call would produce an invalid
+	 * document, an exception is thrown.
+	 *
+	 * The outermost value must be an object, which is either begun by begin_object, or written in
+	 * full by value. Memory usage only depends on the nesting depth. After the outermost object has
+	 * been closed, the next object can be written.
+	 *
+	 * \ingroup serialization
+	 */
+	template<sink Sink>
+	class stream_writer
+	{
+	public:
+		explicit stream_writer(Sink&& sink):m_sink{std::forward<Sink>(sink)}
+		{}
+
+		/**
+		 * \brief Begins a new object
+		 *
+		 * Within an array of objects, this begins the next element.
+		 */
+		void begin_object()
+		{
+			if(in_object_array())
+			{
+				m_frames.push_back(frame{frame_kind::element, nullptr});
+				return;
+			}
+
+			begin_value(type_info<object>::name());
+			serializer_detail::emit(std::string_view{"obj{"}, m_sink);
+			m_frames.push_back(frame{frame_kind::object, nullptr});
+		}
+
+		/**
+		 * \brief Writes the key of the next property of the current object
+		 */
+		void key(std::string_view name)
+		{
+			if(std::size(m_frames) == 0 || m_frames.back().kind == frame_kind::array)
+			{ throw std::runtime_error{"A key can only be written within an object"}; }
+
+			auto& current = m_frames.back();
+			if(current.key_pending)
+			{ throw std::runtime_error{"Expected a value"}; }
+
+			property_name const key{name};
+			if(current.has_key && !(current.last_key < key))
+			{
+				throw std::runtime_error{std::string{"Key '"}.append(name)
+					.append("' is not greater than the previous key")};
+			}
+
+			store_body(key, m_sink);
+			serializer_detail::emit(':', m_sink);
+			current.last_key = key;
+			current.has_key = true;
+			current.key_pending = true;
+		}
+
+		/**
+		 * \brief Writes a complete value, including its type tag
+		 *
+		 * item may be any value that can be stored by store, such as a number, a string, an
+		 * object, an array, or a described struct.
+		 */
+		template<class T>
+		requires(!std::is_convertible_v<T const&, std::string_view>)
+		void value(T const& item)
+		{
+			begin_value(type_info<T>::name());
+			store(item, m_sink);
+		}
+
+		/**
+		 * \brief Writes a string value
+		 */
+		void value(std::string_view item)
+		{
+			begin_value(type_info<std::string>::name());
+			serializer_detail::emit(std::string_view{type_info<std::string>::name()}, m_sink);
+			serializer_detail::emit('{', m_sink);
+			store_body(item, m_sink);
+			serializer_detail::emit(std::string_view{"\\}"}, m_sink);
+		}
+
+		/**
+		 * \brief Begins an array, whose elements are of type T
+		 *
+		 * The elements are written by array_element. If T is an object type, elements may also be
+		 * written by begin_object.
+		 */
+		template<class T>
+		void begin_array()
+		{
+			using element_type = std::conditional_t<std::is_same_v<T, std::string_view>, std::string, T>;
+			begin_value(type_info<std::vector<element_type>>::name());
+			serializer_detail::emit(std::string_view{type_info<std::vector<element_type>>::name()}, m_sink);
+			serializer_detail::emit('{', m_sink);
+			m_frames.push_back(frame{frame_kind::array, type_info<element_type>::name()});
+		}
+
+		/**
+		 * \brief Writes the next element of the current array
+		 */
+		template<class T>
+		requires(!std::is_convertible_v<T const&, std::string_view>)
+		void array_element(T const& item)
+		{
+			begin_element(type_info<T>::name());
+			store_body(item, m_sink);
+			serializer_detail::emit(std::string_view{"\\;"}, m_sink);
+		}
+
+		/**
+		 * \brief Writes the next element of the current array of strings
+		 */
+		void array_element(std::string_view item)
+		{
+			begin_element(type_info<std::string>::name());
+			store_body(item, m_sink);
+			serializer_detail::emit(std::string_view{"\\;"}, m_sink);
+		}
+
+		/**
+		 * \brief Ends the innermost object, or array
+		 */
+		void end()
+		{
+			if(std::size(m_frames) == 0)
+			{ throw std::runtime_error{"No value here to end"}; }
+
+			auto const current = m_frames.back();
+			if(current.key_pending)
+			{ throw std::runtime_error{"Expected a value"}; }
+
+			m_frames.pop_back();
+			serializer_detail::emit(std::string_view{current.kind == frame_kind::element? "\\;" : "\\}"},
+				m_sink);
+		}
+
+		/**
+		 * \brief Returns the number of values that are currently open
+		 */
+		size_t level() const
+		{ return std::size(m_frames); }
+
+		decltype(auto) sink()
+		{ return (m_sink); }
+
+	private:
+		enum class frame_kind{object, element, array};
+
+		struct frame
+		{
+			frame_kind kind;
+			char const* element_tag;
+			property_name last_key{};
+			bool has_key{false};
+			bool key_pending{false};
+		};
+
+		Sink m_sink;
+		std::vector<frame> m_frames;
+
+		bool in_object_array() const
+		{
+			return std::size(m_frames) != 0 && m_frames.back().kind == frame_kind::array
+				&& std::string_view{m_frames.back().element_tag} == type_info<object>::name();
+		}
+
+		void begin_value(std::string_view tag)
+		{
+			if(std::size(m_frames) == 0)
+			{
+				if(tag != type_info<object>::name())
+				{ throw std::runtime_error{"The outermost value must be an obj"}; }
+				return;
+			}
+
+			auto& current = m_frames.back();
+			if(!current.key_pending)
+			{
+				throw std::runtime_error{current.kind == frame_kind::array?
+					"Use array_element to write array elements" : "Expected a key"};
+			}
+			current.key_pending = false;
+		}
+
+		void begin_element(std::string_view tag)
+		{
+			if(std::size(m_frames) == 0 || m_frames.back().kind != frame_kind::array)
+			{ throw std::runtime_error{"An array element can only be written within an array"}; }
+
+			if(tag != m_frames.back().element_tag)
+			{
+				throw std::runtime_error{std::string{"Expected an element of type "}
+					.append(m_frames.back().element_tag)};
+			}
+		}
+	};
+
+	template<sink Sink>
+	stream_writer(Sink&) -> stream_writer<Sink&>;
+}
+
+#endif
@@ -0,0 +1,218 @@
+//@	{"target":{"name":"stream_writer.test"}}
+
+#include "./stream_writer.hpp"
+#include "./deserializer.hpp"
+
+#include "testfwk/testfwk.hpp"
+
+#include <functional>
+
+namespace
+{
+	struct point
+	{
+		double x;
+		double y;
+	};
+}
+
+template<>
+struct anon::schema<point>
+{
+	static constexpr std::tuple members{
+		anon::member{"x", &point::x},
+		anon::member{"y", &point::y}
+	};
+};
+
+namespace
+{
+	struct chunked_buffer
+	{
+		std::string_view data;
+		bool done{false};
+	};
+
+	anon::chunk_read_result read_chunk(chunked_buffer& buff)
+	{
+		if(buff.done)
+		{ return anon::chunk_read_result{std::span<char const>{}, anon::stream_status::eof}; }
+
+		buff.done = true;
+		return anon::chunk_read_result{std::span{std::data(buff.data), std::size(buff.data)},
+			anon::stream_status::ready};
+	}
+
+	anon::object make_object()
+	{
+		anon::object row_1;
+		row_1.insert(anon::property_name{"id"}, uint64_t{1});
+		row_1.insert(anon::property_name{"name"}, std::string{"Alice \\ Bob"});
+
+		anon::object row_2;
+		row_2.insert(anon::property_name{"id"}, uint64_t{2});
+
+		anon::object origin;
+		origin.insert(anon::property_name{"x"}, 1.0);
+		origin.insert(anon::property_name{"y"}, 2.0);
+
+		anon::object ret;
+		ret.insert(anon::property_name{"empty"}, anon::object{});
+		ret.insert(anon::property_name{"origin"}, std::move(origin));
+		ret.insert(anon::property_name{"rows"}, std::vector{std::move(row_1), std::move(row_2), anon::object{}});
+		ret.insert(anon::property_name{"tags"}, std::vector<std::string>{"a", "b"});
+		ret.insert(anon::property_name{"title"}, std::string{"Test"});
+		ret.insert(anon::property_name{"values"}, std::vector<int32_t>{1, 2, 3});
+		return ret;
+	}
+
+	using writer_type = anon::stream_writer<anon::string_writer>;
+
+	void expect_error(std::function<void(writer_type&)> const& calls)
+	{
+		std::string output;
+		anon::stream_writer writer{anon::string_writer{output}};
+		try
+		{
+			calls(writer);
+			testcaseFailed();
+		}
+		catch(std::runtime_error const&)
+		{}
+	}
+}
+
+TESTCASE(anon_stream_writer_write)
+{
+	std::string output;
+	anon::stream_writer writer{anon::string_writer{output}};
+	writer.begin_object();
+	writer.key("empty");
+	writer.begin_object();
+	writer.end();
+	writer.key("origin");
+	writer.value(point{1.0, 2.0});
+	writer.key("rows");
+	writer.begin_array<anon::object>();
+	{
+		writer.begin_object();
+		writer.key("id");
+		writer.value(uint64_t{1});
+		writer.key("name");
+		writer.value("Alice \\ Bob");
+		writer.end();
+
+		anon::object row;
+		row.insert(anon::property_name{"id"}, uint64_t{2});
+		writer.array_element(row);
+
+		writer.begin_object();
+		writer.end();
+	}
+	writer.end();
+	writer.key("tags");
+	writer.begin_array<std::string_view>();
+	writer.array_element("a");
+	writer.array_element(std::string{"b"});
+	writer.end();
+	writer.key("title");
+	writer.value(std::string{"Test"});
+	writer.key("values");
+	writer.begin_array<int32_t>();
+	EXPECT_EQ(writer.level(), 2);
+	for(int32_t k = 1; k != 4; ++k)
+	{ writer.array_element(k); }
+	writer.end();
+	writer.end();
+	EXPECT_EQ(writer.level(), 0);
+
+	EXPECT_EQ(output, anon::to_string(make_object()));
+
+	chunked_buffer buff{output};
+	EXPECT_EQ(anon::to_string(anon::load(buff)), output);
+}
+
+TESTCASE(anon_stream_writer_multiple_values)
+{
+	std::string output;
+	anon::stream_writer writer{anon::string_writer{output}};
+	writer.begin_object();
+	writer.key("a");
+	writer.value(int32_t{1});
+	writer.end();
+	writer.value(point{1.0, 2.0});
+	writer.begin_object();
+	writer.end();
+	EXPECT_EQ(output, R"(obj{a:i32{1\}\}obj{x:f64{1e+00\}y:f64{2e+00\}\}obj{\})");
+}
+
+TESTCASE(anon_stream_writer_errors)
+{
+	expect_error([](writer_type& writer) { writer.key("a"); });
+	expect_error([](writer_type& writer) { writer.end(); });
+	expect_error([](writer_type& writer) {
+		writer.begin_object();
+		writer.value(1);
+	});
+	expect_error([](writer_type& writer) {
+		writer.begin_object();
+		writer.key("Not valid");
+	});
+	expect_error([](writer_type& writer) {
+		writer.begin_object();
+		writer.key("b");
+		writer.value(1);
+		writer.key("a");
+	});
+	expect_error([](writer_type& writer) {
+		writer.begin_object();
+		writer.key("a");
+		writer.value(1);
+		writer.key("a");
+	});
+	expect_error([](writer_type& writer) {
+		writer.begin_object();
+		writer.key("a");
+		writer.key("b");
+	});
+	expect_error([](writer_type& writer) {
+		writer.begin_object();
+		writer.key("a");
+		writer.end();
+	});
+	expect_error([](writer_type& writer) {
+		writer.begin_object();
+		writer.key("a");
+		writer.begin_array<int32_t>();
+		writer.array_element(1.0);
+	});
+	expect_error([](writer_type& writer) {
+		writer.begin_object();
+		writer.key("a");
+		writer.begin_array<int32_t>();
+		writer.value(1);
+	});
+	expect_error([](writer_type& writer) {
+		writer.begin_object();
+		writer.key("a");
+		writer.begin_array<int32_t>();
+		writer.begin_object();
+	});
+	expect_error([](writer_type& writer) {
+		writer.begin_object();
+		writer.key("a");
+		writer.begin_array<anon::object>();
+		writer.key("a");
+	});
+	expect_error([](writer_type& writer) { writer.array_element(1); });
+	expect_error([](writer_type& writer) { writer.value(5); });
+	expect_error([](writer_type& writer) { writer.value("a"); });
+	expect_error([](writer_type& writer) { writer.begin_array<int32_t>(); });
+	expect_error([](writer_type& writer) { writer.begin_array<anon::object>(); });
+	expect_error([](writer_type& writer) { writer.value(std::vector<anon::object>{}); });
+	expect_error([](writer_type& writer) {
+		writer.begin_object();
+		writer.key("a");
+		writer.value(std::string_view{"\0", 1});
+	});
+}
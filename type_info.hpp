@@ -37,7 +37,7 @@ namespace anon
 	 *
 	 * \ingroup type_info
 	 */
-	enum class parser_state:int{init, type_tag, after_type_tag, key, after_key, ctrl_char, value};
+	enum class parser_state:int{init, type_tag, after_type_tag, key, after_key, ctrl_char, value, skip};
 
 	/**
 	 * \brief Struct that should contain type meta-data
@@ -130,24 +130,24 @@ namespace anon
 	};
 
 	/**
-	 * \brief specialization of type_info for std::string
+	 * \brief specialization of type_info for std::string, and strings with a different allocator
 	 *
 	 * \ingroup type_info
 	 */
-	template<>
-	struct type_info<std::string>
+	template<class Allocator>
+	struct type_info<std::basic_string<char, std::char_traits<char>, Allocator>>
 	{
 		static constexpr auto parser_init_state(){ return parser_state::value; }
 		static constexpr char const* name(){ return "str"; }
 	};
 
 	/**
-	 * \brief specialization of type_info for object
+	 * \brief specialization of type_info for basic_object
 	 *
 	 * \ingroup type_info
 	 */
-	template<>
-	struct type_info<object>
+	template<class Storage>
+	struct type_info<basic_object<Storage>>
 	{
 		static constexpr auto parser_init_state(){ return parser_state::key; }
 		static constexpr char const* name(){ return "obj"; }
@@ -158,8 +158,8 @@ namespace anon
 	 *
 	 * \ingroup type_info
 	 */
-	template<class T>
-	struct type_info<std::vector<T>> : type_info<T>
+	template<class T, class Allocator>
+	struct type_info<std::vector<T, Allocator>> : type_info<T>
 	{
 		/**
 		 * \brief Returns the name of the type std::vector<T>
@@ -182,5 +182,15 @@ namespace anon
 
 		static constexpr auto namebuff = make_namebuff();
 	};
+
+	/**
+	 * \brief specialization of type_info for cow_sequence, which has the same type information as
+	 * the wrapped container
+	 *
+	 * \ingroup type_info
+	 */
+	template<class Container>
+	struct type_info<cow_sequence<Container>> : type_info<Container>
+	{};
 }
 #endif
\ No newline at end of file
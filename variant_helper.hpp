@@ -36,6 +36,14 @@ namespace anon::variant_helper
 		}
 	}
 
+	/**
+	 * @brief The index of T in Variant, or std::variant_npos if Variant cannot hold a T
+	 */
+	template<class T, class Variant>
+	constexpr size_t index_of = find_type<Variant>([]<class U>(empty<U>){
+		return std::is_same_v<T, U>;
+	});
+
 	template<class Callback, class ... Args>
 	using callback_wrapper = void (*)(Callback&&, Args&&...);
 